@@ -153,18 +153,66 @@ namespace Oxygen
 
         }
 
+        // pressed state
+        const bool pressed(
+            (_status&Pressed) ||
+            ( _type == ButtonSticky && _client.isOnAllDesktops()  ) ||
+            ( _type == ButtonAbove && _client.keepAbove() ) ||
+            ( _type == ButtonBelow && _client.keepBelow() ) );
+
+        // animated buttons are rendered directly, to avoid polluting the shared pixmaps
+        if( isAnimated() || _client.glowIsAnimated() )
+        {
+            renderButton( painter, base, glow, color, pressed );
+            return;
+        }
+
+        // button face, including icon, is shared by all decorations
+        WindecoButtonKey key;
+        key.type = _type;
+        key.size = width();
+        key.pressed = pressed;
+        key.base = base.isValid() ? base.rgba():0;
+        key.glow = glow.isValid() ? glow.rgba():0;
+
+        if( isMenuButton() ) key.icon = _client.icon().cacheKey();
+        else {
+
+            key.color = color.rgba();
+            if( _type == ButtonMax ) key.variant = _client.maximizeMode();
+            else if( _type == ButtonShade ) key.variant = isChecked();
+
+        }
+
+        QPixmap* pixmap( _helper.windecoButtonFaceCache().object( key ) );
+        if( !pixmap )
+        {
+
+            pixmap = new QPixmap( size() );
+            pixmap->fill( Qt::transparent );
+
+            QPainter local( pixmap );
+            local.setRenderHints( QPainter::Antialiasing );
+            renderButton( local, base, glow, color, pressed );
+            local.end();
+
+            _helper.windecoButtonFaceCache().insert( key, pixmap );
+
+        }
+
+        painter.drawPixmap( 0, 0, *pixmap );
+
+    }
+
+    //___________________________________________________
+    void Button::renderButton( QPainter& painter, const QColor& base, const QColor& glow, const QColor& color, bool pressed ) const
+    {
+
         if( hasDecoration() )
         {
             // scale
             qreal scale( (21.0*_client.buttonSize())/22.0 );
 
-            // pressed state
-            const bool pressed(
-                (_status&Pressed) ||
-                ( _type == ButtonSticky && _client.isOnAllDesktops()  ) ||
-                ( _type == ButtonAbove && _client.keepAbove() ) ||
-                ( _type == ButtonBelow && _client.keepBelow() ) );
-
             // draw button shape
             painter.drawPixmap(0, 0, _helper.windecoButton( base, glow, pressed, scale ) );
 
@@ -331,7 +379,7 @@ namespace Oxygen
     }
 
     //___________________________________________________
-    void Button::drawIcon( QPainter* painter )
+    void Button::drawIcon( QPainter* painter ) const
     {
 
         painter->save();
@@ -111,8 +111,11 @@ namespace Oxygen
         // parent update
         void parentUpdate( void );
 
+        //! render button face and icon
+        void renderButton( QPainter&, const QColor& base, const QColor& glow, const QColor& color, bool pressed ) const;
+
         //! draw icon
-        void drawIcon( QPainter* );
+        void drawIcon( QPainter* ) const;
 
         //! color
         QColor buttonDetailColor( const QPalette& ) const;
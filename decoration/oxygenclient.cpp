@@ -66,7 +66,9 @@ namespace Oxygen
         _mouseButton( Qt::NoButton ),
         _itemData( this ),
         _sourceItem( -1 ),
-        _shadowAtom( 0 )
+        _shadowAtom( 0 ),
+        _hasBackgroundGradient( false ),
+        _hasBackgroundPixmap( false )
     {}
 
     //___________________________________________
@@ -76,6 +78,9 @@ namespace Oxygen
         // delete sizegrip if any
         if( hasSizeGrip() ) deleteSizeGrip();
 
+        // window id may get reused by another client
+        _factory->unregisterClient( windowId() );
+
     }
 
     //___________________________________________
@@ -106,6 +111,7 @@ namespace Oxygen
         // title animation data
         _titleAnimationData->initialize();
         connect( _titleAnimationData, SIGNAL(pixmapsChanged()), SLOT(updateTitleRect()) );
+        connect( _titleAnimationData, SIGNAL(captionChangeReady()), SLOT(processCaptionChange()) );
 
         // lists
         connect( _itemData.animation().data(), SIGNAL(finished()), this, SLOT(clearTargetItem()) );
@@ -157,6 +163,7 @@ namespace Oxygen
 
         // title transitions
         _titleAnimationData->setDuration( _configuration->titleAnimationsDuration() );
+        _titleAnimationData->setCoalescingDelay( _configuration->titleChangesCoalescingDelay() );
 
         // tabs
         _itemData.setAnimationsEnabled( animationsEnabled() && _configuration->tabAnimationsEnabled() );
@@ -181,6 +188,9 @@ namespace Oxygen
         // transparency
         _transparencyEnabled = _configuration->transparencyEnabled() && (windowId() == 0 || ( !_configuration->opacityFromStyle() ) || helper().hasArgb( windowId() ) );
 
+        // background hints
+        updateBackgroundHints();
+
         // handle size grip
         if( _configuration->drawSizeGrip() && _configuration->frameBorder() == Configuration::BorderNone )
         {
@@ -611,7 +621,7 @@ namespace Oxygen
     {
 
         // window background
-        if( helper().hasBackgroundGradient( windowId() ) )
+        if( _hasBackgroundGradient )
         {
 
             int offset = layoutMetric( LM_OuterPaddingTop );
@@ -648,7 +658,7 @@ namespace Oxygen
         }
 
         // background pixmap
-        if( isPreview() || helper().hasBackgroundPixmap( windowId() ) )
+        if( isPreview() || _hasBackgroundPixmap )
         {
             int offset = layoutMetric( LM_OuterPaddingTop );
 
@@ -932,13 +942,24 @@ namespace Oxygen
         const int titleHeight = layoutMetric(LM_TitleHeight);
         const int titleTop = layoutMetric(LM_TitleEdgeTop) + r.top();
 
-        // set color
-        QColor local( color );
+        // separator rect
+        const QRect rect( QRect(r.top(), titleTop+titleHeight-1.5, r.width(), 2).translated( -position ) );
+
         if( glowIsAnimated() && _configuration->separatorMode() != Configuration::SeparatorAlways )
-        { local = helper().alphaColor( color, glowIntensity() ); }
+        {
+
+            // animated separators are rendered directly, to avoid polluting the shared pixmaps
+            helper().drawSeparator( painter, rect, helper().alphaColor( color, glowIntensity() ), Qt::Horizontal);
 
-        // render
-        helper().drawSeparator( painter, QRect(r.top(), titleTop+titleHeight-1.5, r.width(), 2).translated( -position ), local, Qt::Horizontal);
+        } else {
+
+            // render shared pixmap, stretched to match the title width
+            painter->save();
+            painter->setRenderHint( QPainter::SmoothPixmapTransform );
+            painter->drawPixmap( rect, helper().windecoSeparator( color ) );
+            painter->restore();
+
+        }
 
         if (clipRect.isValid()) { painter->restore(); }
 
@@ -1053,6 +1074,10 @@ namespace Oxygen
         const Qt::Alignment alignment( titleAlignment() | Qt::AlignVCenter );
         const QString local( elide ? QFontMetrics( painter->font() ).elidedText( caption, Qt::ElideRight, rect.width() ):caption );
 
+        // use shared static text, to avoid laying out the text at every repaint
+        const QStaticText& staticText( helper().titleStaticText( local, painter->font() ) );
+        const QPointF position( helper().titleTextPosition( rect, staticText.size(), alignment ) );
+
         // translate title down in case of maximized window
         if( isMaximized() ) painter->translate( 0, 2 );
 
@@ -1060,12 +1085,12 @@ namespace Oxygen
         {
             painter->setPen( contrast );
             painter->translate( 0, 1 );
-            painter->drawText( rect, alignment, local );
+            painter->drawStaticText( position, staticText );
             painter->translate( 0, -1 );
         }
 
         painter->setPen( color );
-        painter->drawText( rect, alignment, local );
+        painter->drawStaticText( position, staticText );
 
         // translate back
         if( isMaximized() ) painter->translate( 0, -2 );
@@ -1078,19 +1103,19 @@ namespace Oxygen
 
         if( !rect.isValid() ) return QPixmap();
 
-        QPixmap out( rect.size() );
-        out.fill( Qt::transparent );
-        if( caption.isEmpty() || !color.isValid() ) return out;
+        if( caption.isEmpty() || !color.isValid() )
+        {
+            QPixmap out( rect.size() );
+            out.fill( Qt::transparent );
+            return out;
+        }
 
-        QPainter painter( &out );
-        painter.setFont( options()->font(isActive(), false) );
+        const QFont font( options()->font(isActive(), false) );
         const Qt::Alignment alignment( titleAlignment() | Qt::AlignVCenter );
-        const QString local( elide ? QFontMetrics( painter.font() ).elidedText( caption, Qt::ElideRight, rect.width() ):caption );
+        const QString local( elide ? QFontMetrics( font ).elidedText( caption, Qt::ElideRight, rect.width() ):caption );
 
-        painter.setPen( color );
-        painter.drawText( out.rect(), alignment, local );
-        painter.end();
-        return out;
+        // pixmaps are shared, so that switching back to a recent caption does not re-render the text
+        return helper().titleText( local, font, color, rect.size(), alignment );
 
     }
 
@@ -1236,16 +1261,12 @@ namespace Oxygen
     void Client::renderCorners( QPainter* painter, const QRect& frame, const QPalette& palette ) const
     {
 
+        // outline is shared by all decorations with the same background color
         const QColor color( backgroundColor( widget(), palette ) );
-
-        QLinearGradient lg = QLinearGradient(0, -0.5, 0, qreal( frame.height() )+0.5);
-        lg.setColorAt(0.0, helper().calcLightColor( helper().backgroundTopColor(color) ));
-        lg.setColorAt(0.51, helper().backgroundBottomColor(color) );
-        lg.setColorAt(1.0, helper().backgroundBottomColor(color) );
-
-        painter->setPen( QPen( lg, 1 ) );
-        painter->setBrush( Qt::NoBrush );
-        painter->drawRoundedRect( QRectF( frame ).adjusted( 0.5, 0.5, -0.5, -0.5 ), 3.5,  3.5 );
+        painter->save();
+        painter->setRenderHint( QPainter::SmoothPixmapTransform );
+        helper().windecoCorners( color )->render( frame, painter, TileSet::Ring );
+        painter->restore();
 
     }
 
@@ -1331,6 +1352,13 @@ namespace Oxygen
 
     }
 
+    //_________________________________________________________
+    void Client::updateBackgroundHints( void )
+    {
+        _hasBackgroundGradient = helper().hasBackgroundGradient( windowId() );
+        _hasBackgroundPixmap = helper().hasBackgroundPixmap( windowId() );
+    }
+
     //_________________________________________________________
     void Client::activeChange( void )
     {
@@ -1338,6 +1366,9 @@ namespace Oxygen
         KCommonDecorationUnstable::activeChange();
         _itemData.setDirty( true );
 
+        // background hints might have changed since last reset
+        updateBackgroundHints();
+
         // reset animation
         if( shadowAnimationsEnabled() )
         {
@@ -1372,6 +1403,15 @@ namespace Oxygen
 
     //_________________________________________________________
     void Client::captionChange( void  )
+    {
+
+        // collapse rapid caption changes
+        if( _titleAnimationData->captionChanged() ) processCaptionChange();
+
+    }
+
+    //_________________________________________________________
+    void Client::processCaptionChange( void  )
     {
 
         KCommonDecorationUnstable::captionChange();
@@ -1449,7 +1489,12 @@ namespace Oxygen
 
             case QEvent::Show:
             if( widget() == object )
-            { _itemData.setDirty( true ); }
+            {
+                _itemData.setDirty( true );
+
+                // background hints are usually set right before the client window is mapped
+                updateBackgroundHints();
+            }
             break;
 
             case QEvent::MouseButtonPress:
@@ -1623,8 +1668,6 @@ namespace Oxygen
 
         }
 
-
-
     }
 
     //_________________________________________________________
@@ -1638,28 +1681,32 @@ namespace Oxygen
         // define frame
         QRect frame = widget()->rect();
 
+        // damaged region, used to skip decoration parts that need no repaint
+        const QRegion damage( painter.hasClipping() ? painter.clipRegion():QRegion( frame ) );
+
         // base color
         QColor color = palette.window().color();
 
-        // draw shadows
-        if( compositingActive() && shadowCache().shadowSize() > 0 && !isMaximized() )
+        // draw shadows, unless damage is entirely inside the shadow ring.
+        // Shadow tiles overlap the window body by ShadowCache::overlap pixels
+        const int shadowSize( shadowCache().shadowSize() );
+        const int shadowExtent( shadowSize + ShadowCache::overlap );
+        if( compositingActive() && shadowSize > 0 && !isMaximized() &&
+            hasDamageOutside( damage, frame.adjusted( shadowExtent, shadowExtent, -shadowExtent, -shadowExtent ) ) )
         {
 
-            TileSet *tileSet( 0 );
             const ShadowCache::Key key( this->key() );
             if( shadowCache().isEnabled( QPalette::Active ) && glowIsAnimated() && !isForcedActive() )
             {
 
-                tileSet = shadowCache().tileSet( key, glowIntensity() );
+                shadowCache().render( key, glowIntensity(), frame, &painter, TileSet::Ring );
 
             } else {
 
-                tileSet = shadowCache().tileSet( key );
+                shadowCache().tileSet( key )->render( frame, &painter, TileSet::Ring);
 
             }
 
-            tileSet->render( frame, &painter, TileSet::Ring);
-
         }
 
         // adjust frame
@@ -1689,7 +1736,9 @@ namespace Oxygen
                 if( _configuration->frameBorder() == Configuration::BorderNone && !isShade() ) bottom = 0;
                 QRegion mask( helper().roundedMask( frame, left, right, top, bottom ) );
 
-                renderCorners( &painter, frame, palette );
+                if( hasDamageOutside( damage, frame.adjusted( 4, 4, -4, -4 ) ) )
+                { renderCorners( &painter, frame, palette ); }
+
                 painter.setClipRegion( mask, Qt::IntersectClip );
 
             }
@@ -1756,11 +1805,12 @@ namespace Oxygen
             frame.adjust(-1,-1, 1, 1);
         }
 
-        // float frame
-        renderFloatFrame( &painter, frame, palette );
-
-        // resize handles
-        renderDots( &painter, frame, backgroundColor( widget(), palette ) );
+        // float frame and resize handles, drawn along the window edges
+        if( hasDamageOutside( damage, frame.adjusted( 10, 10, -10, -10 ) ) )
+        {
+            renderFloatFrame( &painter, frame, palette );
+            renderDots( &painter, frame, backgroundColor( widget(), palette ) );
+        }
 
         if( !hideTitleBar() )
         {
@@ -1769,14 +1819,20 @@ namespace Oxygen
             painter.setFont( options()->font(isActive(), false) );
 
             // draw ClientGroupItems
+            // only items intersecting damage are rendered. Bounding rects are extended to account for title outline
             const int itemCount( _itemData.count() );
-            for( int i = 0; i < itemCount; i++ ) renderItem( &painter, i, palette );
+            for( int i = 0; i < itemCount; i++ )
+            {
+                if( damage.intersects( _itemData[i]._boundingRect.adjusted( -8, -8, 8, 8 ) ) )
+                { renderItem( &painter, i, palette ); }
+            }
 
             // draw target rect
             renderTargetRect( &painter, widget()->palette() );
 
             // separator
-            if( itemCount == 1 && !_itemData.isAnimated() && drawSeparator() )
+            const QRect separatorRect( frame.left(), frame.top() + layoutMetric( LM_TitleEdgeTop ) + layoutMetric( LM_TitleHeight ) - 4, frame.width(), 8 );
+            if( itemCount == 1 && !_itemData.isAnimated() && drawSeparator() && damage.intersects( separatorRect ) )
             { renderSeparator(&painter, frame, widget(), color ); }
 
         }
@@ -343,6 +343,15 @@ namespace Oxygen
         //! render dots
         virtual void renderDots( QPainter*, const QRect&, const QColor& ) const;
 
+        //! read background hints from the client window
+        /*! they are stored, to avoid X server round trips when painting */
+        void updateBackgroundHints( void );
+
+        //! true if some of the damaged region lies outside of given rect
+        /*! it is used to skip parts of the decoration that are drawn along the window edges */
+        static bool hasDamageOutside( const QRegion& damage, const QRect& rect )
+        { return !( damage - QRegion( rect ) ).isEmpty(); }
+
         //@}
 
         //! close tab matching give button
@@ -425,6 +434,9 @@ namespace Oxygen
 
         protected slots:
 
+        //! process caption change, once coalesced
+        void processCaptionChange( void );
+
         //! set target item to -1
         void clearTargetItem( void );
 
@@ -493,6 +505,12 @@ namespace Oxygen
         //! shadow atom
         Atom _shadowAtom;
 
+        //!@name background hints, read from the client window
+        //@{
+        bool _hasBackgroundGradient;
+        bool _hasBackgroundPixmap;
+        //@}
+
     };
 
 } // namespace Oxygen
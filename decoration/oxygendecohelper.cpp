@@ -35,7 +35,24 @@ namespace Oxygen
         Helper(componentName),
         _debugArea( KDebug::registerArea( "Oxygen (decoration)" ) )
 
-    {}
+    {
+
+        // cache names, used for statistics
+        _windecoButtonCache.setName( "windecoButton" );
+        _windecoButtonFaceCache.setName( "windecoButtonFace" );
+        _windecoCornersCache.setName( "windecoCorners" );
+        _titleTextCache.setName( "titleText" );
+        _titleStaticTextCache.setName( "titleStaticText" );
+        _decoRoundedMaskCache.setName( "decoRoundedMask" );
+
+        // title text pixmaps are large, keep only the most recent ones
+        _titleTextCache.setMaxCost( 32 );
+        _decoRoundedMaskCache.setMaxCost( 32 );
+        _windecoSeparatorCache.setName( "windecoSeparator" );
+        _titleBarTextColorCache.setName( "titleBarTextColor" );
+        _buttonTextColorCache.setName( "buttonTextColor" );
+
+    }
 
     //______________________________________________________________________________
     void DecoHelper::invalidateCaches( void )
@@ -45,6 +62,12 @@ namespace Oxygen
 
         // local caches
         _windecoButtonCache.clear();
+        _windecoButtonFaceCache.clear();
+        _windecoCornersCache.clear();
+        _titleTextCache.clear();
+        _titleStaticTextCache.clear();
+        _decoRoundedMaskCache.clear();
+        _windecoSeparatorCache.clear();
         _titleBarTextColorCache.clear();
         _buttonTextColorCache.clear();
 
@@ -54,10 +77,8 @@ namespace Oxygen
     QPixmap DecoHelper::windecoButton(const QColor &color, const QColor& glow, bool sunken, int size)
     {
 
-        Oxygen::Cache<QPixmap>::Value* cache( _windecoButtonCache.get( color ) );
-
         const quint64 key( ( colorKey(glow) << 32 ) | (sunken << 23 ) | size );
-        QPixmap *pixmap = cache->object( key );
+        QPixmap *pixmap = _windecoButtonCache.object( color, key );
 
         if( !pixmap )
         {
@@ -128,24 +149,166 @@ namespace Oxygen
             }
 
             p.end();
-            cache->insert( key, pixmap );
+            _windecoButtonCache.insert( color, key, pixmap );
+        }
+
+        return *pixmap;
+    }
+
+    //______________________________________________________________________________
+    QPixmap DecoHelper::titleText( const QString& text, const QFont& font, const QColor& color, const QSize& size, Qt::Alignment alignment )
+    {
+
+        TitleTextKey key( text, font );
+        key.color = color.rgba();
+        key.alignment = alignment;
+        key.size = size;
+
+        QPixmap* pixmap( _titleTextCache.object( key ) );
+        if( !pixmap )
+        {
+
+            pixmap = new QPixmap( size );
+            pixmap->fill( Qt::transparent );
+
+            QPainter p( pixmap );
+            p.setFont( font );
+            p.setPen( color );
+            const QStaticText& staticText( titleStaticText( text, font ) );
+            p.drawStaticText( titleTextPosition( QRect( QPoint(), size ), staticText.size(), alignment ), staticText );
+            p.end();
+
+            _titleTextCache.insert( key, pixmap );
+
+        }
+
+        return *pixmap;
+
+    }
+
+    //______________________________________________________________________________
+    const QStaticText& DecoHelper::titleStaticText( const QString& text, const QFont& font )
+    {
+
+        const TitleTextKey key( text, font );
+        QStaticText* staticText( _titleStaticTextCache.object( key ) );
+        if( !staticText )
+        {
+
+            staticText = new QStaticText( text );
+            staticText->setTextFormat( Qt::PlainText );
+            staticText->setPerformanceHint( QStaticText::AggressiveCaching );
+            staticText->prepare( QTransform(), font );
+            _titleStaticTextCache.insert( key, staticText );
+
+        }
+
+        return *staticText;
+
+    }
+
+    //______________________________________________________________________________
+    QPointF DecoHelper::titleTextPosition( const QRect& rect, const QSizeF& size, Qt::Alignment alignment ) const
+    {
+
+        qreal x( rect.left() );
+        if( alignment & Qt::AlignHCenter ) x += 0.5*( rect.width() - size.width() );
+        else if( alignment & Qt::AlignRight ) x += rect.width() - size.width();
+
+        // round, to keep text aligned on pixels, as QPainter::drawText does
+        return QPointF( qRound( x ), qRound( rect.top() + 0.5*( rect.height() - size.height() ) ) );
+
+    }
+
+    //______________________________________________________________________________
+    TileSet* DecoHelper::windecoCorners( const QColor& color )
+    {
+
+        const quint64 key( colorKey( color ) );
+        TileSet* tileSet( _windecoCornersCache.object( key ) );
+        if( !tileSet )
+        {
+
+            /*
+            the outline is rendered once, for a reference height, and side tiles are stretched
+            to match the actual window height. The vertical gradient is scaled accordingly
+            */
+            const int height( 256 );
+            const int width( 16 );
+            QPixmap pixmap( width, height );
+            pixmap.fill( Qt::transparent );
+
+            QPainter p( &pixmap );
+            p.setRenderHints( QPainter::Antialiasing );
+
+            QLinearGradient lg = QLinearGradient(0, -0.5, 0, qreal( height )+0.5);
+            lg.setColorAt(0.0, calcLightColor( backgroundTopColor(color) ));
+            lg.setColorAt(0.51, backgroundBottomColor(color) );
+            lg.setColorAt(1.0, backgroundBottomColor(color) );
+
+            p.setPen( QPen( lg, 1 ) );
+            p.setBrush( Qt::NoBrush );
+            p.drawRoundedRect( QRectF( 0, 0, width, height ).adjusted( 0.5, 0.5, -0.5, -0.5 ), 3.5,  3.5 );
+            p.end();
+
+            tileSet = new TileSet( pixmap, 6, 6, width-12, height-12, true );
+            _windecoCornersCache.insert( key, tileSet );
+
+        }
+
+        return tileSet;
+
+    }
+
+    //______________________________________________________________________________
+    const QPixmap& DecoHelper::windecoSeparator( const QColor& color )
+    {
+
+        const quint64 key( colorKey( color ) );
+        QPixmap* pixmap( _windecoSeparatorCache.object( key ) );
+        if( !pixmap )
+        {
+
+            // rendered for a reference width, and stretched to match the actual title width
+            const int width( 256 );
+            pixmap = new QPixmap( width, 2 );
+            pixmap->fill( Qt::transparent );
+
+            QPainter p( pixmap );
+            drawSeparator( &p, QRect( 0, 0, width, 2 ), color, Qt::Horizontal );
+            p.end();
+
+            _windecoSeparatorCache.insert( key, pixmap );
+
         }
 
         return *pixmap;
+
     }
 
     //_______________________________________________________________________
     QRegion DecoHelper::decoRoundedMask( const QRect& r, int left, int right, int top, int bottom ) const
     {
         // get rect geometry
-        int x, y, w, h;
-        r.getRect(&x, &y, &w, &h);
+        const int w( r.width() );
+        const int h( r.height() );
+
+        const CacheKey key(
+            ( quint64( w ) << 32 ) | quint32( h ),
+            quint8( left ) | ( quint8( right ) << 8 ) | ( quint8( top ) << 16 ) | ( quint64( quint8( bottom ) ) << 24 ) );
 
-        QRegion mask(x + 3*left, y + 0*top, w-3*(left+right), h-0*(top+bottom));
-        mask += QRegion(x + 0*left, y + 3*top, w-0*(left+right), h-3*(top+bottom));
-        mask += QRegion(x + 1*left, y + 1*top, w-1*(left+right), h-1*(top+bottom));
+        QRegion* mask( _decoRoundedMaskCache.object( key ) );
+        if( !mask )
+        {
+
+            mask = new QRegion(3*left, 0*top, w-3*(left+right), h-0*(top+bottom));
+            *mask += QRegion(0*left, 3*top, w-0*(left+right), h-3*(top+bottom));
+            *mask += QRegion(1*left, 1*top, w-1*(left+right), h-1*(top+bottom));
+            _decoRoundedMaskCache.insert( key, mask );
+
+        }
 
-        return mask;
+        return mask->translated( r.topLeft() );
     }
 
     //______________________________________________________________________________
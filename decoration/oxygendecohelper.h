@@ -24,11 +24,129 @@
 
 #include "oxygenhelper.h"
 
+#include <QtGui/QFont>
+#include <QtGui/QStaticText>
+
 //! helper class
 /*! contains utility functions used at multiple places in oxygen style */
 namespace Oxygen
 {
 
+    //! key for shared button faces
+    /*! it holds everything needed to render a button, including its icon */
+    class WindecoButtonKey
+    {
+        public:
+
+        //! constructor
+        explicit WindecoButtonKey( void ):
+            type( 0 ),
+            variant( 0 ),
+            size( 0 ),
+            pressed( false ),
+            base( 0 ),
+            glow( 0 ),
+            color( 0 ),
+            icon( 0 )
+        {}
+
+        //! equal to operator
+        bool operator == ( const WindecoButtonKey& other ) const
+        {
+            return
+                type == other.type &&
+                variant == other.variant &&
+                size == other.size &&
+                pressed == other.pressed &&
+                base == other.base &&
+                glow == other.glow &&
+                color == other.color &&
+                icon == other.icon;
+        }
+
+        //! button type
+        int type;
+
+        //! type dependent icon variant (maximize mode, checked state)
+        int variant;
+
+        //! button size
+        int size;
+
+        //! pressed state
+        bool pressed;
+
+        //! button color
+        QRgb base;
+
+        //! glow color
+        QRgb glow;
+
+        //! icon color
+        QRgb color;
+
+        //! application icon cache key, for menu buttons
+        qint64 icon;
+
+    };
+
+    //! hash
+    inline uint qHash( const WindecoButtonKey& key )
+    {
+        return qHash( CacheKey(
+            ( quint64( key.base ) << 32 ) | key.color,
+            ( ( quint64( key.glow ) << 32 ) | ( key.type << 16 ) | ( key.variant << 12 ) | ( key.pressed << 11 ) | key.size ) ^ quint64( key.icon ) ) );
+    }
+
+    //! key for shared title texts
+    class TitleTextKey
+    {
+        public:
+
+        //! constructor
+        explicit TitleTextKey( const QString& text = QString(), const QFont& font = QFont() ):
+            text( text ),
+            font( font.key() ),
+            color( 0 ),
+            alignment( 0 )
+        {}
+
+        //! equal to operator
+        bool operator == ( const TitleTextKey& other ) const
+        {
+            return
+                color == other.color &&
+                alignment == other.alignment &&
+                size == other.size &&
+                text == other.text &&
+                font == other.font;
+        }
+
+        //! text
+        QString text;
+
+        //! font key
+        QString font;
+
+        //! color
+        QRgb color;
+
+        //! alignment
+        int alignment;
+
+        //! pixmap size
+        QSize size;
+
+    };
+
+    //! hash
+    inline uint qHash( const TitleTextKey& key )
+    {
+        return qHash( CacheKey(
+            ( quint64( ::qHash( key.text ) ) << 32 ) | ::qHash( key.font ),
+            ( quint64( key.color ) << 32 ) | ( quint64( key.alignment ) << 24 ) | ( ( key.size.width()&0xfff ) << 12 ) | ( key.size.height()&0xfff ) ) );
+    }
+
     class DecoHelper : public Helper
     {
 
@@ -52,8 +170,35 @@ namespace Oxygen
         //!
         //@{
         virtual QPixmap windecoButton(const QColor &color, const QColor& glow, bool sunken, int size = 21);
+
+        //! title text, rendered with given font and color in a transparent pixmap of given size
+        QPixmap titleText( const QString&, const QFont&, const QColor&, const QSize&, Qt::Alignment );
+
+        //! title text static text, prepared for given font
+        /*! the static text keeps the shaped glyph runs, so that repainting a title does not require text layout */
+        const QStaticText& titleStaticText( const QString&, const QFont& );
+
+        //! position of a static text of given size, aligned in rect
+        QPointF titleTextPosition( const QRect&, const QSizeF&, Qt::Alignment ) const;
+
+        //! window corners outline, to be rendered with TileSet::Ring
+        TileSet* windecoCorners( const QColor& );
+
+        //! title separator, to be stretched horizontally
+        const QPixmap& windecoSeparator( const QColor& );
         //@}
 
+        //! shared button faces, including icons
+        typedef BaseCache<QPixmap, WindecoButtonKey> WindecoButtonFaceCache;
+
+        //! shared button faces
+        /*!
+        button faces are rendered by the buttons themselves, since they depend on button type,
+        and stored here so that they are shared by all decorations
+        */
+        WindecoButtonFaceCache& windecoButtonFaceCache( void )
+        { return _windecoButtonFaceCache; }
+
         //
         virtual QRegion decoRoundedMask( const QRect&, int left = 1, int right = 1, int top = 1, int bottom = 1 ) const;
 
@@ -76,6 +221,24 @@ namespace Oxygen
         //! windeco buttons
         Cache<QPixmap> _windecoButtonCache;
 
+        //! windeco button faces
+        WindecoButtonFaceCache _windecoButtonFaceCache;
+
+        //! title texts
+        BaseCache<QPixmap, TitleTextKey> _titleTextCache;
+
+        //! title static texts
+        BaseCache<QStaticText, TitleTextKey> _titleStaticTextCache;
+
+        //! rounded masks, at origin
+        mutable BaseCache<QRegion, CacheKey> _decoRoundedMaskCache;
+
+        //! windeco corners
+        BaseCache<TileSet> _windecoCornersCache;
+
+        //! windeco separators
+        PixmapCache _windecoSeparatorCache;
+
         //! titleBar text color cache
         ColorCache _titleBarTextColorCache;
 
@@ -45,7 +45,9 @@ namespace Oxygen
     Factory::Factory():
         _initialized( false ),
         _helper( "oxygenDeco" ),
-        _shadowCache( _helper )
+        _shadowCache( _helper ),
+        _hasTitleExceptions( false ),
+        _hasClassExceptions( false )
     {
         readConfig();
         setInitialized( true );
@@ -99,6 +101,26 @@ namespace Oxygen
         exceptions.readConfig( config );
         _exceptions = exceptions.get();
 
+        // compile enabled exceptions
+        _compiledExceptions.clear();
+        _hasTitleExceptions = false;
+        _hasClassExceptions = false;
+        foreach( const ConfigurationPtr& configuration, _exceptions )
+        {
+
+            // discard disabled exceptions and exceptions with empty exception pattern
+            if( !configuration->enabled() || configuration->exceptionPattern().isEmpty() ) continue;
+
+            _compiledExceptions.append( Exception( configuration ) );
+            if( configuration->exceptionType() == Configuration::ExceptionWindowTitle ) _hasTitleExceptions = true;
+            else _hasClassExceptions = true;
+
+        }
+
+        // clear match caches
+        _classNames.clear();
+        _exceptionMatches.clear();
+
         // read opacity from style, if required
         if( _defaultConfiguration->opacityFromStyle() )
         {
@@ -117,6 +139,15 @@ namespace Oxygen
         _shadowCache.readConfig();
         _shadowCache.setAnimationsDuration( _defaultConfiguration->shadowAnimationsDuration() );
 
+        // cross-fade animated shadows, or render them in the background, to avoid hitches on first focus change
+        _shadowCache.setInterpolationEnabled( _defaultConfiguration->shadowAnimationsInterpolated() );
+        _shadowCache.setPrewarmEnabled( _defaultConfiguration->animationsEnabled() && _defaultConfiguration->shadowAnimationsEnabled() );
+        {
+            ShadowCache::Key key;
+            key.hasBorder = ( _defaultConfiguration->frameBorder() > Configuration::BorderNone );
+            _shadowCache.prewarm( key );
+        }
+
         // background pixmap
         {
             KConfigGroup group( config->group("Common") );
@@ -177,55 +208,108 @@ namespace Oxygen
     Factory::ConfigurationPtr Factory::configuration( const Client& client )
     {
 
-        QString windowTitle;
-        QString className;
-        foreach( const ConfigurationPtr& configuration, _exceptions )
-        {
+        if( _compiledExceptions.isEmpty() ) return _defaultConfiguration;
+
+        // only retrieve the values that are needed
+        const QString windowTitle( _hasTitleExceptions ? client.caption():QString() );
+        const QString className( _hasClassExceptions ? this->className( client.windowId() ):QString() );
 
-            // discard disabled exceptions
-            if( !configuration->enabled() ) continue;
+        // check match cache
+        const QString key( className + QChar( 0 ) + windowTitle );
+        QHash<QString, int>::const_iterator iter( _exceptionMatches.constFind( key ) );
+        if( iter != _exceptionMatches.constEnd() )
+        { return iter.value() < 0 ? _defaultConfiguration:_compiledExceptions[iter.value()].configuration; }
 
-            // discard exceptions with empty exception pattern
-            if( configuration->exceptionPattern().isEmpty() ) continue;
+        // find first matching exception
+        int index( -1 );
+        for( int i = 0; i < _compiledExceptions.size(); ++i )
+        {
 
             /*
             decide which value is to be compared
             to the regular expression, based on exception type
             */
-            QString value;
-            switch( configuration->exceptionType() )
+            const Exception& exception( _compiledExceptions[i] );
+            const QString& value( exception.configuration->exceptionType() == Configuration::ExceptionWindowTitle ? windowTitle:className );
+            if( exception.match( value ) )
             {
-                case Configuration::ExceptionWindowTitle:
-                {
-                    value = windowTitle.isEmpty() ? (windowTitle = client.caption()):windowTitle;
-                    break;
-                }
-
-                default:
-                case Configuration::ExceptionWindowClassName:
-                {
-                    if( className.isEmpty() )
-                    {
-                        // retrieve class name
-                        KWindowInfo info( client.windowId(), 0, NET::WM2WindowClass );
-                        QString window_className( info.windowClassName() );
-                        QString window_class( info.windowClassClass() );
-                        className = window_className + ' ' + window_class;
-                    }
-
-                    value = className;
-                    break;
-                }
+                index = i;
+                break;
+            }
+
+        }
+
+        // store, making sure the cache does not grow indefinitely with changing titles
+        if( _exceptionMatches.size() >= 1024 ) _exceptionMatches.clear();
+        _exceptionMatches.insert( key, index );
+
+        return index < 0 ? _defaultConfiguration:_compiledExceptions[index].configuration;
+
+    }
+
+    //____________________________________________________________________
+    QString Factory::className( WId id )
+    {
+
+        QHash<WId, QString>::const_iterator iter( _classNames.constFind( id ) );
+        if( iter != _classNames.constEnd() ) return iter.value();
+
+        // retrieve class name
+        KWindowInfo info( id, 0, NET::WM2WindowClass );
+        QString window_className( info.windowClassName() );
+        QString window_class( info.windowClassClass() );
+        const QString className( window_className + ' ' + window_class );
+
+        _classNames.insert( id, className );
+        return className;
+
+    }
+
+    //____________________________________________________________________
+    Factory::Exception::Exception( const ConfigurationPtr& configuration ):
+        configuration( configuration ),
+        regExp( configuration->exceptionPattern() ),
+        anchored( false )
+    {
+
+        const QString pattern( configuration->exceptionPattern() );
+
+        // alternations make any literal optional
+        if( pattern.contains( '|' ) ) return;
 
+        // collect leading literal characters
+        static const QString special( "\\.[](){}*+?^$|" );
+        anchored = pattern.startsWith( '^' );
+        for( int i = anchored ? 1:0; i < pattern.size(); ++i )
+        {
+
+            const QChar c( pattern[i] );
+            if( !special.contains( c ) )
+            {
+                literal += c;
+                continue;
             }
 
-            // check matching
-            if( QRegExp( configuration->exceptionPattern() ).indexIn( value ) >= 0 )
-            { return configuration; }
+            // these quantifiers make the previous character optional
+            if( c == '*' || c == '?' || c == '{' ) literal.chop( 1 );
+            break;
 
         }
 
-        return _defaultConfiguration;
+    }
+
+    //____________________________________________________________________
+    bool Factory::Exception::match( const QString& value ) const
+    {
+
+        // prefilter
+        if( !literal.isEmpty() )
+        {
+            if( anchored && !value.startsWith( literal ) ) return false;
+            else if( !anchored && !value.contains( literal ) ) return false;
+        }
+
+        return regExp.indexIn( value ) >= 0;
 
     }
 
@@ -33,6 +33,8 @@
 #include "oxygenshadowcache.h"
 
 #include <QObject>
+#include <QHash>
+#include <QRegExp>
 #include <kdecorationfactory.h>
 #include <kdeversion.h>
 
@@ -98,6 +100,11 @@ namespace Oxygen
         //! get configuration for a give client
         virtual ConfigurationPtr configuration( const Client& );
 
+        //! remove cached data associated to a client window
+        /*! it is called when the client is destroyed, since window ids get reused */
+        void unregisterClient( WId id )
+        { _classNames.remove( id ); }
+
         protected:
 
         //! read configuration from KConfig
@@ -115,6 +122,35 @@ namespace Oxygen
             return out;
         }
 
+        //! window class name, as used for exception matching
+        QString className( WId );
+
+        //! enabled exception, with precompiled pattern
+        class Exception
+        {
+            public:
+
+            //! constructor
+            explicit Exception( const ConfigurationPtr& );
+
+            //! true if value matches exception pattern
+            bool match( const QString& ) const;
+
+            //! configuration
+            ConfigurationPtr configuration;
+
+            //! regular expression
+            QRegExp regExp;
+
+            //! literal string any matching value must contain, if any
+            /*! it is used to discard non matching values without running the regular expression */
+            QString literal;
+
+            //! true if literal must be found at the start of the value
+            bool anchored;
+
+        };
+
         private:
 
         //! initialization flag
@@ -132,6 +168,21 @@ namespace Oxygen
         //! list of exceptiosn
         QList<ConfigurationPtr> _exceptions;
 
+        //! enabled exceptions, with precompiled patterns
+        QList<Exception> _compiledExceptions;
+
+        //! true if some enabled exceptions match window titles
+        bool _hasTitleExceptions;
+
+        //! true if some enabled exceptions match window class names
+        bool _hasClassExceptions;
+
+        //! window class names, indexed by window id. Entries are removed when clients are destroyed
+        QHash<WId, QString> _classNames;
+
+        //! matching exception index, indexed by window class name and title
+        QHash<QString, int> _exceptionMatches;
+
     };
 
 }
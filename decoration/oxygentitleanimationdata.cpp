@@ -39,6 +39,9 @@ namespace Oxygen
     TitleAnimationData::TitleAnimationData( QObject* parent ):
         QObject( parent ),
         _dirty( false ),
+        _coalescingDelay( 0 ),
+        _captionChangePending( false ),
+        _droppedFrames( 0 ),
         _animation( new Animation( 200, this ) ),
         _opacity(0)
     {}
@@ -54,6 +57,40 @@ namespace Oxygen
         animation().data()->setPropertyName( "opacity" );
         animation().data()->setEasingCurve( QEasingCurve::InOutQuad );
 
+        // pending caption changes are processed once the transition is over
+        connect( animation().data(), SIGNAL(finished()), SLOT(processPendingCaptionChange()) );
+
+    }
+
+    //_________________________________________________________
+    bool TitleAnimationData::captionChanged( void )
+    {
+
+        // process immediately if no transition is running and no change was processed recently
+        if( !( isAnimated() || _coalescingTimer.isActive() ) )
+        {
+            if( _coalescingDelay > 0 ) _coalescingTimer.start( _coalescingDelay, this );
+            return true;
+        }
+
+        // the previously pending caption is overridden, and will never be rendered
+        if( _captionChangePending ) ++_droppedFrames;
+        _captionChangePending = true;
+        return false;
+
+    }
+
+    //_________________________________________________________
+    void TitleAnimationData::processPendingCaptionChange( void )
+    {
+
+        if( !_captionChangePending || isAnimated() || _coalescingTimer.isActive() ) return;
+
+        // restart coalescing window and notify
+        _captionChangePending = false;
+        if( _coalescingDelay > 0 ) _coalescingTimer.start( _coalescingDelay, this );
+        emit captionChangeReady();
+
     }
 
 
@@ -85,6 +122,13 @@ namespace Oxygen
     void TitleAnimationData::timerEvent( QTimerEvent* e )
     {
 
+        if( e->timerId() == _coalescingTimer.timerId() )
+        {
+            _coalescingTimer.stop();
+            processPendingCaptionChange();
+            return;
+        }
+
         if( e->timerId() != _animationLockTimer.timerId() )
         { return QObject::timerEvent( e ); }
 
@@ -84,6 +84,28 @@ namespace Oxygen
             animation().data()->setDuration( duration );
         }
 
+        //!@name caption changes coalescing
+        //@{
+
+        //! delay during which caption changes are collapsed into a single transition (milliseconds)
+        void setCoalescingDelay( int value )
+        { _coalescingDelay = value; }
+
+        //! caption changed
+        /*!
+        returns true if the change must be processed immediately. Otherwise the change is delayed
+        until either the coalescing delay has expired or the running transition is finished,
+        at which point captionChangeReady is emitted. Changes that are overridden by a newer
+        caption before being processed are counted as dropped frames
+        */
+        bool captionChanged( void );
+
+        //! number of caption changes that were never rendered
+        int droppedFrames( void ) const
+        { return _droppedFrames; }
+
+        //@}
+
         //! retrieve contrast pixmap
         QPixmap contrastPixmap( void ) const
         { return _contrastPixmap.currentPixmap(); }
@@ -123,6 +145,10 @@ namespace Oxygen
         {
             assert( isAnimated() );
             animation().data()->stop();
+
+            // process pending caption change from the event loop
+            if( _captionChangePending && !_coalescingTimer.isActive() )
+            { _coalescingTimer.start( 0, this ); }
         }
 
         //@}
@@ -158,6 +184,14 @@ namespace Oxygen
 
         void pixmapsChanged( void );
 
+        //! emitted when a delayed caption change must be processed
+        void captionChangeReady( void );
+
+        protected slots:
+
+        //! process pending caption change, if any
+        void processPendingCaptionChange( void );
+
         protected:
 
         //! update pixmaps
@@ -244,6 +278,18 @@ namespace Oxygen
         //! timer used to disable animations when triggered too early
         QBasicTimer _animationLockTimer;
 
+        //! coalescing delay (milliseconds)
+        int _coalescingDelay;
+
+        //! timer used to collapse caption changes
+        QBasicTimer _coalescingTimer;
+
+        //! true when a caption change is waiting to be processed
+        bool _captionChangePending;
+
+        //! number of caption changes that were never rendered
+        int _droppedFrames;
+
         //! title animation
         Animation::Pointer _animation;
 
@@ -26,3 +26,131 @@
 
 #include "oxygenanimation.h"
 #include "oxygenanimation.moc"
+
+#include "oxygenanimationclock.h"
+
+namespace Oxygen
+{
+
+    //____________________________________________________________
+    Animation::Animation( int duration, QObject* parent ):
+        QObject( parent ),
+        _state( Stopped ),
+        _duration( duration ),
+        _direction( Forward ),
+        _from( 0 )
+    {}
+
+    //____________________________________________________________
+    Animation::~Animation( void )
+    { if( isRunning() ) AnimationClock::instance().unschedule( this ); }
+
+    //____________________________________________________________
+    void Animation::setDuration( int duration )
+    {
+        if( duration == _duration ) return;
+        if( !isRunning() ) { _duration = duration; return; }
+
+        // keep current position
+        const int position( AnimationClock::instance().position( this ) );
+        _duration = duration;
+        AnimationClock::instance().schedule( this, qMin( position, duration ) );
+    }
+
+    //____________________________________________________________
+    void Animation::setDirection( Direction direction )
+    {
+        if( direction == _direction ) return;
+        if( !isRunning() ) { _direction = direction; return; }
+
+        // keep current position, so that the value continues from where it is
+        const int position( AnimationClock::instance().position( this ) );
+        _direction = direction;
+        AnimationClock::instance().schedule( this, position );
+    }
+
+    //____________________________________________________________
+    void Animation::setTargetObject( QObject* target )
+    {
+        if( target == _target ) return;
+        _target = target;
+        updateProperty();
+    }
+
+    //____________________________________________________________
+    void Animation::setPropertyName( const QByteArray& name )
+    {
+        if( name == _propertyName ) return;
+        _propertyName = name;
+        updateProperty();
+    }
+
+    //____________________________________________________________
+    void Animation::start( void )
+    {
+
+        if( isRunning() ) return;
+
+        // resolve start value
+        if( _startValue.isValid() ) _from = _startValue.toReal();
+        else if( _target && _property.isValid() ) _from = _property.read( _target ).toReal();
+        else _from = 0;
+
+        // write initial value
+        _state = Running;
+        const bool forward( _direction == Forward );
+        setProgress( forward ? 0:1 );
+        if( !isRunning() ) return;
+
+        if( _duration <= 0 ) finish();
+        else AnimationClock::instance().schedule( this, forward ? 0:_duration );
+
+    }
+
+    //____________________________________________________________
+    void Animation::stop( void )
+    {
+        if( !isRunning() ) return;
+        AnimationClock::instance().unschedule( this );
+        _state = Stopped;
+    }
+
+    //____________________________________________________________
+    void Animation::setProgress( qreal progress )
+    {
+
+        // target got deleted
+        if( !_target )
+        {
+            stop();
+            return;
+        }
+
+        const QVariant value( _from + ( _endValue.toReal() - _from )*_easingCurve.valueForProgress( progress ) );
+        if( _property.isValid() ) _property.write( _target, value );
+        emit valueChanged( value );
+
+    }
+
+    //____________________________________________________________
+    void Animation::finish( void )
+    {
+        setProgress( _direction == Forward ? 1:0 );
+        _state = Stopped;
+        emit finished();
+    }
+
+    //____________________________________________________________
+    void Animation::updateProperty( void )
+    {
+
+        _property = QMetaProperty();
+        if( !_target || _propertyName.isEmpty() ) return;
+
+        const QMetaObject* metaObject( _target.data()->metaObject() );
+        const int index( metaObject->indexOfProperty( _propertyName.constData() ) );
+        if( index >= 0 ) _property = metaObject->property( index );
+
+    }
+
+}
@@ -26,16 +26,26 @@
 // IN THE SOFTWARE.
 //////////////////////////////////////////////////////////////////////////////
 
-#include <QtCore/QWeakPointer>
-#include <QtCore/QPropertyAnimation>
+#include <QtCore/QByteArray>
+#include <QtCore/QEasingCurve>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
 #include <QtCore/QVariant>
+#include <QtCore/QWeakPointer>
 
 #include "oxygen_export.h"
 
 namespace Oxygen
 {
 
-    class OXYGEN_EXPORT Animation: public QPropertyAnimation
+    //! animates a numeric property of a target object, between start and end values
+    /*!
+    it provides the subset of QPropertyAnimation used by the animation engines.
+    Running animations are not driven by their own timer, but advanced together
+    by the process wide AnimationClock
+    */
+    class OXYGEN_EXPORT Animation: public QObject
     {
 
         Q_OBJECT
@@ -45,18 +55,84 @@ namespace Oxygen
         //! TimeLine shared pointer
         typedef QWeakPointer<Animation> Pointer;
 
+        //! direction
+        enum Direction
+        {
+            Forward,
+            Backward
+        };
+
+        //! state
+        enum State
+        {
+            Stopped,
+            Running
+        };
+
         //! constructor
-        Animation( int duration, QObject* parent ):
-            QPropertyAnimation( parent )
-        { setDuration( duration ); }
+        Animation( int duration, QObject* parent );
 
         //! destructor
-        virtual ~Animation( void )
-        {}
+        virtual ~Animation( void );
+
+        //! state
+        State state( void ) const
+        { return _state; }
 
         //! true if running
         bool isRunning( void ) const
-        { return state() == Animation::Running; }
+        { return _state == Running; }
+
+        //! duration (msec)
+        int duration( void ) const
+        { return _duration; }
+
+        //! duration (msec)
+        void setDuration( int );
+
+        //! direction
+        Direction direction( void ) const
+        { return _direction; }
+
+        //! direction
+        /*! when running, the animation continues from its current value towards the new end */
+        void setDirection( Direction );
+
+        //! target object
+        QObject* targetObject( void ) const
+        { return _target; }
+
+        //! target object
+        void setTargetObject( QObject* );
+
+        //! property name
+        const QByteArray& propertyName( void ) const
+        { return _propertyName; }
+
+        //! property name
+        void setPropertyName( const QByteArray& );
+
+        //! start value
+        /*! when invalid, the current property value is used */
+        void setStartValue( const QVariant& value )
+        { _startValue = value; }
+
+        //! end value
+        void setEndValue( const QVariant& value )
+        { _endValue = value; }
+
+        //! easing curve
+        void setEasingCurve( const QEasingCurve& curve )
+        { _easingCurve = curve; }
+
+        public slots:
+
+        //! start
+        /*! animation starts from the start value when going forward, and from the end value otherwise */
+        void start( void );
+
+        //! stop
+        void stop( void );
 
         //! restart
         void restart( void )
@@ -65,6 +141,61 @@ namespace Oxygen
             start();
         }
 
+        signals:
+
+        //! emitted when the animation reaches its end
+        void finished( void );
+
+        //! emitted whenever the property is written
+        void valueChanged( const QVariant& );
+
+        protected:
+
+        //! write property for given progress, in [0,1]
+        /*! it is called by the clock at each tick */
+        void setProgress( qreal );
+
+        //! write final value, stop and emit finished signal
+        /*! it is called by the clock once the duration has elapsed */
+        void finish( void );
+
+        //! resolve target property
+        void updateProperty( void );
+
+        private:
+
+        //! state
+        State _state;
+
+        //! duration
+        int _duration;
+
+        //! direction
+        Direction _direction;
+
+        //! target
+        QPointer<QObject> _target;
+
+        //! property name
+        QByteArray _propertyName;
+
+        //! resolved property, so that no lookup by name is needed when writing
+        QMetaProperty _property;
+
+        //! start value
+        QVariant _startValue;
+
+        //! start value, resolved when starting
+        qreal _from;
+
+        //! end value
+        QVariant _endValue;
+
+        //! easing curve
+        QEasingCurve _easingCurve;
+
+        friend class AnimationClock;
+
     };
 
 }
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygenanimationclock.h"
+#include "oxygenanimation.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Oxygen
+{
+
+    //____________________________________________________________
+    AnimationClock& AnimationClock::instance( void )
+    {
+        // the clock is never deleted. Its timer only runs while animations are running,
+        // and animations are owned by objects that are deleted before the library is unloaded
+        static AnimationClock* clock( new AnimationClock() );
+        return *clock;
+    }
+
+    //____________________________________________________________
+    AnimationClock::AnimationClock( void ):
+        _ticking( false )
+    { _clock.start(); }
+
+    //____________________________________________________________
+    void AnimationClock::schedule( Animation* animation, int position )
+    {
+
+        int index( indexOf( animation ) );
+        if( index < 0 )
+        {
+            index = _records.size();
+            _records.append( Record( animation ) );
+        }
+
+        Record& record( _records[index] );
+        record.duration = animation->duration();
+        record.forward = ( animation->direction() == Animation::Forward );
+        record.start = _clock.elapsed() - ( record.forward ? position : record.duration - position );
+
+        if( !_timer.isActive() ) _timer.start( interval, this );
+
+    }
+
+    //____________________________________________________________
+    void AnimationClock::unschedule( Animation* animation )
+    {
+
+        const int index( indexOf( animation ) );
+        if( index < 0 ) return;
+
+        // records are only compacted at the end of the tick
+        if( _ticking ) _records[index].animation = 0;
+        else _records.remove( index );
+
+        if( _records.isEmpty() ) _timer.stop();
+
+    }
+
+    //____________________________________________________________
+    int AnimationClock::position( const Animation* animation ) const
+    {
+
+        const int index( indexOf( animation ) );
+        if( index < 0 ) return 0;
+
+        const Record& record( _records[index] );
+        const int elapsed( qBound<qint64>( 0, _clock.elapsed() - record.start, record.duration ) );
+        return record.forward ? elapsed : record.duration - elapsed;
+
+    }
+
+    //____________________________________________________________
+    void AnimationClock::update( QWidget* widget, const QRect& rect )
+    {
+
+        if( !_ticking )
+        {
+            if( rect.isValid() ) widget->update( rect );
+            else widget->update();
+            return;
+        }
+
+        // merge with pending update of the same widget
+        for( int i = 0; i < _updates.size(); ++i )
+        {
+            Update& update( _updates[i] );
+            if( update.widget.data() != widget ) continue;
+            if( update.rect.isValid() ) update.rect = rect.isValid() ? update.rect.united( rect ):QRect();
+            return;
+        }
+
+        _updates.append( Update( widget, rect ) );
+
+    }
+
+    //____________________________________________________________
+    void AnimationClock::timerEvent( QTimerEvent* event )
+    {
+
+        if( event->timerId() != _timer.timerId() ) return QObject::timerEvent( event );
+
+        // advance all animations. Records may be added or removed meanwhile
+        _ticking = true;
+        const qint64 now( _clock.elapsed() );
+        for( int i = 0; i < _records.size(); ++i )
+        {
+
+            const Record record( _records[i] );
+            if( !record.animation ) continue;
+
+            const qint64 elapsed( now - record.start );
+            if( elapsed >= record.duration )
+            {
+
+                _records[i].animation = 0;
+                record.animation->finish();
+
+            } else {
+
+                const qreal progress( qreal( elapsed )/record.duration );
+                record.animation->setProgress( record.forward ? progress : 1.0 - progress );
+
+            }
+
+        }
+
+        // remove finished animations
+        int count( 0 );
+        for( int i = 0; i < _records.size(); ++i )
+        { if( _records[i].animation ) _records[count++] = _records[i]; }
+        _records.resize( count );
+
+        _ticking = false;
+
+        // send merged updates
+        const QVector<Update> updates( _updates );
+        _updates.clear();
+        foreach( const Update& update, updates )
+        {
+            if( !update.widget ) continue;
+            if( update.rect.isValid() ) update.widget.data()->update( update.rect );
+            else update.widget.data()->update();
+        }
+
+        if( _records.isEmpty() ) _timer.stop();
+
+    }
+
+    //____________________________________________________________
+    int AnimationClock::indexOf( const Animation* animation ) const
+    {
+        for( int i = 0; i < _records.size(); ++i )
+        { if( _records[i].animation == animation ) return i; }
+        return -1;
+    }
+
+}
@@ -0,0 +1,150 @@
+#ifndef oxygenanimationclock_h
+#define oxygenanimationclock_h
+
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygen_export.h"
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QRect>
+#include <QtCore/QVector>
+#include <QtGui/QWidget>
+
+namespace Oxygen
+{
+
+    class Animation;
+
+    //! process wide clock, advancing all running animations at once
+    /*!
+    running animations are stored in a flat array of records. A single timer
+    advances them all, and only runs while at least one animation is running,
+    so that idle processes get no wakeups. Widget updates requested while
+    advancing the animations are merged, and sent once per widget at the end of the tick
+    */
+    class OXYGEN_EXPORT AnimationClock: public QObject
+    {
+
+        public:
+
+        //! singleton
+        static AnimationClock& instance( void );
+
+        //! tick interval (msec)
+        enum { interval = 16 };
+
+        //! add animation, or move it, so that it is at given position (msec) now
+        void schedule( Animation*, int position );
+
+        //! remove animation
+        void unschedule( Animation* );
+
+        //! current position of a scheduled animation (msec)
+        int position( const Animation* ) const;
+
+        //! update widget
+        /*!
+        when called while advancing animations, the update is delayed to the end of the tick,
+        and merged with other updates of the same widget. An invalid rect updates the full widget
+        */
+        void update( QWidget*, const QRect& = QRect() );
+
+        protected:
+
+        //! timer event
+        /*! used to advance animations */
+        virtual void timerEvent( QTimerEvent* );
+
+        private:
+
+        //! constructor
+        AnimationClock( void );
+
+        //! index of animation record, or -1
+        int indexOf( const Animation* ) const;
+
+        //! running animation
+        class Record
+        {
+            public:
+
+            //! constructor
+            explicit Record( Animation* animation = 0 ):
+                animation( animation ),
+                start( 0 ),
+                duration( 0 ),
+                forward( true )
+            {}
+
+            //! animation. It is reset to zero when removed during a tick
+            Animation* animation;
+
+            //! start time, as the clock time at which position was zero when going forward
+            qint64 start;
+
+            //! duration
+            int duration;
+
+            //! direction
+            bool forward;
+
+        };
+
+        //! pending update
+        class Update
+        {
+            public:
+
+            //! constructor
+            explicit Update( QWidget* widget = 0, const QRect& rect = QRect() ):
+                widget( widget ),
+                rect( rect )
+            {}
+
+            //! widget
+            QPointer<QWidget> widget;
+
+            //! rect. Invalid for full widget updates
+            QRect rect;
+
+        };
+
+        //! running animations
+        QVector<Record> _records;
+
+        //! updates requested during current tick
+        QVector<Update> _updates;
+
+        //! true while advancing animations
+        bool _ticking;
+
+        //! clock
+        QElapsedTimer _clock;
+
+        //! tick timer
+        QBasicTimer _timer;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygencache.h"
+
+#include <KGlobal>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimerEvent>
+
+#include <cstdio>
+
+namespace Oxygen
+{
+
+    //____________________________________________________________________
+    K_GLOBAL_STATIC( CacheBudget, globalCacheBudget )
+
+    //____________________________________________________________________
+    CacheBudget& CacheBudget::instance( void )
+    { return *globalCacheBudget; }
+
+    //____________________________________________________________________
+    bool CacheBudget::isDestroyed( void )
+    { return globalCacheBudget.isDestroyed(); }
+
+    //____________________________________________________________________
+    CacheBudget::CacheBudget( void ):
+        _maxCost( 32*1024*1024 ),
+        _totalCost( 0 ),
+        _tick( 0 )
+    {
+
+        // print statistics periodically
+        const int interval( qgetenv( "OXYGEN_CACHE_STATISTICS_INTERVAL" ).toInt() );
+        if( interval > 0 && QCoreApplication::instance() )
+        { _statisticsTimer.start( 1000*interval, this ); }
+
+    }
+
+    //____________________________________________________________________
+    CacheBudget::~CacheBudget( void )
+    {
+
+        _timer.stop();
+        _statisticsTimer.stop();
+
+        // print statistics on exit
+        if( !qgetenv( "OXYGEN_CACHE_STATISTICS" ).isEmpty() )
+        {
+            QTextStream stream( stderr );
+            print( stream );
+        }
+
+    }
+
+    //____________________________________________________________________
+    void CacheBudget::setMaxCost( qint64 value )
+    {
+        _maxCost = value;
+        addCost( 0 );
+    }
+
+    //____________________________________________________________________
+    void CacheBudget::unregisterCache( AbstractCache* cache )
+    {
+        _caches.removeAll( cache );
+        _totalCost -= cache->totalCost();
+
+        // keep statistics
+        if( !cache->name().isEmpty() )
+        { _deletedStatistics[cache->name()] += cache->statistics(); }
+
+    }
+
+    //____________________________________________________________________
+    void CacheBudget::addCost( qint64 cost )
+    {
+
+        _totalCost += cost;
+        if( _maxCost <= 0 || _totalCost <= _maxCost ) return;
+
+        // trim from the event loop if possible, immediately otherwise
+        if( QCoreApplication::instance() )
+        {
+
+            if( !_timer.isActive() ) _timer.start( 0, this );
+
+        } else trim();
+
+    }
+
+    //____________________________________________________________________
+    void CacheBudget::trim( void )
+    {
+
+        while( _maxCost > 0 && _totalCost > _maxCost )
+        {
+
+            // find cache containing the least recently used object
+            AbstractCache* oldest( 0 );
+            quint64 oldestTick( 0 );
+            foreach( AbstractCache* cache, _caches )
+            {
+                if( cache->totalCost() <= 0 ) continue;
+                const quint64 tick( cache->leastRecentlyUsed() );
+                if( tick && ( !oldest || tick < oldestTick ) )
+                {
+                    oldest = cache;
+                    oldestTick = tick;
+                }
+            }
+
+            if( !oldest ) break;
+            oldest->removeLeastRecentlyUsed();
+
+        }
+
+    }
+
+    //____________________________________________________________________
+    void CacheBudget::print( QTextStream& stream ) const
+    {
+
+        // group caches by name
+        typedef QMap<QString, CacheStatistics> StatisticsMap;
+        StatisticsMap statistics( _deletedStatistics );
+        QMap<QString, int> caches;
+        QMap<QString, int> objects;
+        QMap<QString, qint64> costs;
+        foreach( AbstractCache* cache, _caches )
+        {
+            if( cache->name().isEmpty() ) continue;
+            statistics[cache->name()] += cache->statistics();
+            caches[cache->name()] += 1;
+            objects[cache->name()] += cache->size();
+            costs[cache->name()] += cache->totalCost();
+        }
+
+        // application might already be deleted, when called from the destructor
+        const QString application( QCoreApplication::instance() ? QCoreApplication::applicationName():QString() );
+        stream << "# Oxygen::CacheBudget - application: " << application
+            << " total: " << _totalCost << " bytes max: " << _maxCost << " bytes" << endl;
+        stream << "# name\tcaches\tobjects\tbytes\thits\tmisses\tinserts\tevictions\tbuild ms" << endl;
+        for( StatisticsMap::const_iterator iter = statistics.constBegin(); iter != statistics.constEnd(); ++iter )
+        {
+            const CacheStatistics& value( iter.value() );
+            stream
+                << iter.key() << "\t"
+                << caches.value( iter.key() ) << "\t"
+                << objects.value( iter.key() ) << "\t"
+                << costs.value( iter.key() ) << "\t"
+                << value.hits << "\t"
+                << value.misses << "\t"
+                << value.inserts << "\t"
+                << value.evictions << "\t"
+                << value.buildTime/1000000
+                << endl;
+        }
+
+    }
+
+    //____________________________________________________________________
+    void CacheBudget::timerEvent( QTimerEvent* event )
+    {
+        if( event->timerId() == _timer.timerId() )
+        {
+
+            _timer.stop();
+            trim();
+
+        } else if( event->timerId() == _statisticsTimer.timerId() ) {
+
+            QTextStream stream( stderr );
+            print( stream );
+
+        } else QObject::timerEvent( event );
+    }
+
+}
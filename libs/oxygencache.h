@@ -0,0 +1,561 @@
+#ifndef oxygen_cache_h
+#define oxygen_cache_h
+
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygentileset.h"
+#include "oxygen_export.h"
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QTextStream>
+#include <QtGui/QColor>
+#include <QtGui/QPixmap>
+#include <QtGui/QRegion>
+#include <QtGui/QStaticText>
+
+namespace Oxygen
+{
+
+    class AbstractCache;
+
+    //! cache usage statistics
+    class CacheStatistics
+    {
+        public:
+
+        //! constructor
+        CacheStatistics( void ):
+            hits( 0 ),
+            misses( 0 ),
+            inserts( 0 ),
+            evictions( 0 ),
+            buildTime( 0 )
+        {}
+
+        //! add
+        CacheStatistics& operator += ( const CacheStatistics& other )
+        {
+            hits += other.hits;
+            misses += other.misses;
+            inserts += other.inserts;
+            evictions += other.evictions;
+            buildTime += other.buildTime;
+            return *this;
+        }
+
+        qint64 hits;
+        qint64 misses;
+        qint64 inserts;
+        qint64 evictions;
+
+        //! time spent between a miss and the insertion of the matching object, in nanoseconds
+        qint64 buildTime;
+
+    };
+
+    //! process wide memory budget, shared by all caches
+    /*!
+    each cache charges the memory used by the objects it stores to the budget.
+    When the total exceeds the maximum, least recently used objects are removed,
+    across all caches, until the total fits again. Removal is delayed to the next
+    event loop iteration, so that objects returned by a cache are never deleted
+    while the caller is still painting with them.
+
+    The budget is destroyed with the library's static objects. Statistics are printed
+    to stderr at this time when OXYGEN_CACHE_STATISTICS is set.
+    */
+    class OXYGEN_EXPORT CacheBudget: public QObject
+    {
+
+        public:
+
+        //! singleton
+        /*! it must not be used once destroyed. See isDestroyed */
+        static CacheBudget& instance( void );
+
+        //! true if singleton has been destroyed
+        /*! caches and pages released after static objects must check it before returning their cost */
+        static bool isDestroyed( void );
+
+        //! constructor
+        /*! it is public for the global static. Use instance() instead */
+        CacheBudget( void );
+
+        //! destructor
+        virtual ~CacheBudget( void );
+
+        //! maximum memory, in bytes
+        qint64 maxCost( void ) const
+        { return _maxCost; }
+
+        //! maximum memory, in bytes
+        void setMaxCost( qint64 );
+
+        //! memory currently used by all caches, in bytes
+        qint64 totalCost( void ) const
+        { return _totalCost; }
+
+        //! returns a monotonic counter, used to sort entries across caches
+        quint64 tick( void )
+        { return ++_tick; }
+
+        //! register cache
+        void registerCache( AbstractCache* cache )
+        { _caches.append( cache ); }
+
+        //! unregister cache
+        void unregisterCache( AbstractCache* );
+
+        //! add cost
+        /*! negative values are used when objects are removed */
+        void addCost( qint64 );
+
+        //! remove least recently used objects until total cost fits in budget
+        void trim( void );
+
+        //! print statistics of all registered caches, grouped by name
+        void print( QTextStream& ) const;
+
+        protected:
+
+        //! timer event
+        /*! used to trim the caches from the event loop, and for periodic statistics */
+        virtual void timerEvent( QTimerEvent* );
+
+        private:
+
+        //! maximum memory
+        qint64 _maxCost;
+
+        //! current memory
+        qint64 _totalCost;
+
+        //! tick
+        quint64 _tick;
+
+        //! registered caches
+        QList<AbstractCache*> _caches;
+
+        //! delayed trimming timer
+        QBasicTimer _timer;
+
+        //! periodic statistics timer
+        /*! it is started when OXYGEN_CACHE_STATISTICS_INTERVAL is set to a number of seconds */
+        QBasicTimer _statisticsTimer;
+
+        //! statistics of deleted caches, grouped by name
+        QMap<QString, CacheStatistics> _deletedStatistics;
+
+    };
+
+    //! base class for all caches, used by the memory budget
+    class OXYGEN_EXPORT AbstractCache
+    {
+
+        public:
+
+        //! constructor
+        AbstractCache( void ):
+            _totalCost( 0 ),
+            _missPending( false )
+        { CacheBudget::instance().registerCache( this ); }
+
+        //! destructor
+        virtual ~AbstractCache( void )
+        { if( !CacheBudget::isDestroyed() ) CacheBudget::instance().unregisterCache( this ); }
+
+        //! name, used for statistics
+        const QString& name( void ) const
+        { return _name; }
+
+        //! name, used for statistics
+        virtual void setName( const QString& name )
+        { _name = name; }
+
+        //! memory used by stored objects, in bytes
+        qint64 totalCost( void ) const
+        { return _totalCost; }
+
+        //! number of stored objects
+        virtual int size( void ) const = 0;
+
+        //! tick of the least recently used object, or zero if empty
+        virtual quint64 leastRecentlyUsed( void ) const = 0;
+
+        //! remove least recently used object
+        virtual void removeLeastRecentlyUsed( void ) = 0;
+
+        //! usage statistics
+        const CacheStatistics& statistics( void ) const
+        { return _statistics; }
+
+        protected:
+
+        //! add cost, and forward to budget
+        void addCost( qint64 cost )
+        {
+            if( !cost ) return;
+            _totalCost += cost;
+            if( !CacheBudget::isDestroyed() ) CacheBudget::instance().addCost( cost );
+        }
+
+        //! record hit
+        void hit( void )
+        { ++_statistics.hits; }
+
+        //! record miss, and start measuring time needed to build the missing object
+        void miss( void )
+        {
+            ++_statistics.misses;
+            _missPending = true;
+            _missTimer.start();
+        }
+
+        //! record insertion
+        /*! the build time is accounted if the inserted key matches the last missed one */
+        void inserted( bool matchesMiss )
+        {
+            ++_statistics.inserts;
+            if( _missPending && matchesMiss ) _statistics.buildTime += _missTimer.nsecsElapsed();
+            _missPending = false;
+        }
+
+        //! record eviction
+        void evicted( void )
+        { ++_statistics.evictions; }
+
+        private:
+
+        //! name
+        QString _name;
+
+        //! memory used by stored objects
+        qint64 _totalCost;
+
+        //! statistics
+        CacheStatistics _statistics;
+
+        //! true if last miss was not followed by an insertion yet
+        bool _missPending;
+
+        //! time since last miss
+        QElapsedTimer _missTimer;
+
+    };
+
+    //!@name memory used by cached objects
+    //@{
+
+    //! pixmaps
+    inline qint64 cacheCost( const QPixmap& pixmap )
+    { return qint64( pixmap.width() )*pixmap.height()*pixmap.depth()/8; }
+
+    //! tilesets
+    inline qint64 cacheCost( const TileSet& tileSet )
+    { return tileSet.cost(); }
+
+    //! colors are not accounted, since they are small and returned by reference
+    inline qint64 cacheCost( const QColor& )
+    { return 0; }
+
+    //! regions
+    inline qint64 cacheCost( const QRegion& region )
+    { return qint64( region.rectCount() )*sizeof( QRect ); }
+
+    //! static texts, accounting for their glyph runs only roughly
+    inline qint64 cacheCost( const QStaticText& staticText )
+    { return qint64( staticText.text().size() )*16; }
+
+    //@}
+
+    //! least recently used cache, accounting for the memory used by stored objects
+    /*!
+    maxCost is the maximum number of objects; the memory used by stored objects is charged
+    to the process wide CacheBudget. The interface matches the one of QCache
+    */
+    template<typename T, typename K = quint64> class BaseCache: public AbstractCache
+    {
+
+        public:
+
+        //! constructor
+        BaseCache( int maxCost ):
+            _maxCost( maxCost ),
+            _enabled( true ),
+            _missKey()
+        {}
+
+        //! constructor
+        explicit BaseCache( void ):
+            _maxCost( 100 ),
+            _enabled( true ),
+            _missKey()
+        {}
+
+        //! destructor
+        virtual ~BaseCache( void )
+        { clear(); }
+
+        //! enable
+        void setEnabled( bool value )
+        { _enabled = value; }
+
+        //! enable state
+        bool enabled( void ) const
+        { return _enabled; }
+
+        //! access
+        T* object( const K& key )
+        {
+            if( !_enabled ) return 0;
+            typename EntryMap::iterator iter( _entries.find( key ) );
+            if( iter == _entries.end() )
+            {
+                _missKey = key;
+                miss();
+                return 0;
+            }
+
+            // update access order
+            hit();
+            touch( key, iter.value() );
+            return iter.value().object;
+        }
+
+        //! true if key is in cache
+        bool contains( const K& key ) const
+        { return _entries.contains( key ); }
+
+        //! insert object, taking ownership
+        /*! returns false if the object could not be stored, in which case it is deleted */
+        bool insert( const K& key, T* object )
+        {
+
+            // remove existing object
+            remove( key );
+            if( _maxCost <= 0 )
+            {
+                delete object;
+                return false;
+            }
+
+            // make room
+            while( _entries.size() >= _maxCost )
+            { removeLeastRecentlyUsed(); }
+
+            // insert
+            Entry entry;
+            entry.object = object;
+            entry.cost = cacheCost( *object );
+            entry.tick = 0;
+            touch( key, _entries.insert( key, entry ).value() );
+
+            inserted( key == _missKey );
+            addCost( entry.cost );
+            return true;
+
+        }
+
+        //! remove object matching key
+        bool remove( const K& key )
+        {
+            typename EntryMap::iterator iter( _entries.find( key ) );
+            if( iter == _entries.end() ) return false;
+
+            const Entry entry( iter.value() );
+            _entries.erase( iter );
+            _accessOrder.remove( entry.tick );
+
+            addCost( -entry.cost );
+            delete entry.object;
+            return true;
+        }
+
+        //! clear
+        void clear( void )
+        {
+            qint64 cost( 0 );
+            foreach( const Entry& entry, _entries )
+            {
+                cost += entry.cost;
+                delete entry.object;
+            }
+
+            _entries.clear();
+            _accessOrder.clear();
+            addCost( -cost );
+        }
+
+        //! keys
+        QList<K> keys( void ) const
+        { return _entries.keys(); }
+
+        //! number of stored objects
+        virtual int size( void ) const
+        { return _entries.size(); }
+
+        //! max cost
+        int maxCost( void ) const
+        { return _maxCost; }
+
+        //! max cost
+        void setMaxCost( int cost )
+        {
+            if( cost <= 0 ) {
+
+                clear();
+                _maxCost = 1;
+                setEnabled( false );
+
+            } else {
+
+                setEnabled( true );
+                _maxCost = cost;
+                while( _entries.size() > _maxCost )
+                { removeLeastRecentlyUsed(); }
+
+            }
+        }
+
+        //! tick of least recently used object
+        virtual quint64 leastRecentlyUsed( void ) const
+        { return _accessOrder.isEmpty() ? 0:_accessOrder.constBegin().key(); }
+
+        //! remove least recently used object
+        virtual void removeLeastRecentlyUsed( void )
+        {
+            if( _accessOrder.isEmpty() ) return;
+            const K key( _accessOrder.constBegin().value() );
+            remove( key );
+            evicted();
+        }
+
+        private:
+
+        //! cache entry
+        class Entry
+        {
+            public:
+
+            //! stored object
+            T* object;
+
+            //! memory used by object
+            qint64 cost;
+
+            //! last access
+            quint64 tick;
+
+        };
+
+        //! mark entry as most recently used
+        void touch( const K& key, Entry& entry )
+        {
+            if( entry.tick ) _accessOrder.remove( entry.tick );
+            entry.tick = CacheBudget::instance().tick();
+            _accessOrder.insert( entry.tick, key );
+        }
+
+        //! max number of objects
+        int _maxCost;
+
+        //! enable flag
+        bool _enabled;
+
+        //! entries
+        typedef QHash<K, Entry> EntryMap;
+        EntryMap _entries;
+
+        //! map access tick to key, sorted from least to most recently used
+        QMap<quint64, K> _accessOrder;
+
+        //! last missed key
+        K _missKey;
+
+    };
+
+    //! 128 bits key, used for caches indexed by a color and additional parameters
+    class CacheKey
+    {
+        public:
+
+        //! constructor
+        explicit CacheKey( quint64 first = 0, quint64 second = 0 ):
+            first( first ),
+            second( second )
+        {}
+
+        //! equal to operator
+        bool operator == ( const CacheKey& other ) const
+        { return first == other.first && second == other.second; }
+
+        quint64 first;
+        quint64 second;
+
+    };
+
+    //! hash
+    inline uint qHash( const CacheKey& key )
+    {
+        const uint seed( ::qHash( key.first ) );
+        return seed ^ ( ::qHash( key.second ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 ) );
+    }
+
+    //! cache indexed by a color and a 64 bits key
+    /*!
+    a single table, with a single size limit and eviction order, is used for all colors,
+    so that the number of stored objects is bounded by the max cache size
+    */
+    template<typename T> class Cache: public BaseCache<T, CacheKey>
+    {
+
+        public:
+
+        //! constructor
+        explicit Cache( void )
+        {}
+
+        //! access
+        T* object( const QColor& color, quint64 key )
+        { return BaseCache<T, CacheKey>::object( CacheKey( colorKey( color ), key ) ); }
+
+        //! insert
+        bool insert( const QColor& color, quint64 key, T* object )
+        { return BaseCache<T, CacheKey>::insert( CacheKey( colorKey( color ), key ), object ); }
+
+        //! max cache size
+        void setMaxCacheSize( int value )
+        { BaseCache<T, CacheKey>::setMaxCost( value ); }
+
+        private:
+
+        //! color key, properly accounting for invalid colors
+        static quint64 colorKey( const QColor& color )
+        { return color.isValid() ? color.rgba():0; }
+
+    };
+
+}
+
+#endif
@@ -26,7 +26,12 @@
 #include <KColorScheme>
 #include <KDebug>
 #include <KGlobalSettings>
+#include <KSharedDataCache>
+#include <KStandardDirs>
 
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
 #include <QtGui/QWidget>
 #include <QtGui/QPainter>
 
@@ -52,7 +57,9 @@ namespace Oxygen
     // a KComponentData constructed in the OxygenStyleHelper ctor, we'll just keep
     // one here, even though the window decoration doesn't really need it.
     Helper::Helper( const QByteArray& componentName ):
-        _componentData( componentName, 0, KComponentData::SkipMainComponentRegistration )
+        _componentData( componentName, 0, KComponentData::SkipMainComponentRegistration ),
+        _sharedCache( new KSharedDataCache( "oxygen-transparent-pixmaps", 10*1024*1024 ) ),
+        _sharedCacheEnabled( true )
     {
         _config = _componentData.config();
         _contrast = KGlobalSettings::contrastF( _config );
@@ -62,6 +69,27 @@ namespace Oxygen
         _bgcontrast = qMin( 1.0, 0.9*_contrast/0.7 );
 
         _backgroundCache.setMaxCost( 64 );
+        _windowBackgroundCache.setMaxCost( 16 );
+        _roundedMaskCache.setMaxCost( 32 );
+
+        // cache names, used for statistics
+        _slabCache.setName( "slab" );
+        _slabSunkenCache.setName( "slabSunken" );
+        _decoColorCache.setName( "decoColor" );
+        _lightColorCache.setName( "lightColor" );
+        _darkColorCache.setName( "darkColor" );
+        _shadowColorCache.setName( "shadowColor" );
+        _backgroundTopColorCache.setName( "backgroundTopColor" );
+        _backgroundBottomColorCache.setName( "backgroundBottomColor" );
+        _backgroundRadialColorCache.setName( "backgroundRadialColor" );
+        _backgroundColorCache.setName( "backgroundColor" );
+        _backgroundCache.setName( "background" );
+        _windowBackgroundCache.setName( "windowBackground" );
+        _roundedMaskCache.setName( "roundedMask" );
+        _dotCache.setName( "dot" );
+
+        // shared cache
+        updateSharedCacheKey();
 
         #ifdef Q_WS_X11
 
@@ -76,6 +104,10 @@ namespace Oxygen
 
     }
 
+    //____________________________________________________________________
+    Helper::~Helper( void )
+    { delete _sharedCache; }
+
     //____________________________________________________________________
     KSharedConfigPtr Helper::config() const
     { return _config; }
@@ -92,6 +124,10 @@ namespace Oxygen
         _viewHoverBrush = KStatefulBrush( KColorScheme::View, KColorScheme::HoverColor, config() );
         _viewNegativeTextBrush = KStatefulBrush( KColorScheme::View, KColorScheme::NegativeText, config() );
 
+        // shared cache entries rendered with the previous configuration are not cleared,
+        // since other processes may still use them. They get evicted by the cache itself
+        updateSharedCacheKey();
+
     }
 
         //____________________________________________________________________
@@ -108,6 +144,8 @@ namespace Oxygen
         _backgroundRadialColorCache.clear();
         _backgroundColorCache.clear();
         _backgroundCache.clear();
+        _windowBackgroundCache.clear();
+        _roundedMaskCache.clear();
         _dotCache.clear();
     }
 
@@ -119,10 +157,97 @@ namespace Oxygen
         _slabCache.setMaxCacheSize( value );
         _slabSunkenCache.setMaxCost( value );
         _backgroundCache.setMaxCost( value );
+        _windowBackgroundCache.setMaxCost( qMin( value, 16 ) );
         _dotCache.setMaxCost( value );
 
         /* note: we do not limit the size of the color caches on purpose, since they should be small anyway */
 
+        // shared cache
+        _sharedCacheEnabled = ( value > 0 );
+
+    }
+
+    //____________________________________________________________________
+    bool Helper::findSharedPixmap( const QString& key, QPixmap& pixmap ) const
+    {
+
+        if( !_sharedCacheEnabled ) return false;
+
+        QByteArray data;
+        if( !_sharedCache->find( _sharedCacheKey + key, &data ) ) return false;
+
+        // read dimensions
+        QDataStream stream( data );
+        qint32 width(0), height(0);
+        stream >> width >> height;
+
+        // check dimensions against payload size, before allocating anything
+        const qint64 headerSize( 2*sizeof( qint32 ) );
+        if( stream.status() != QDataStream::Ok || width <= 0 || height <= 0 ) return false;
+        if( qint64( width )*height*4 != qint64( data.size() ) - headerSize ) return false;
+
+        // check consistency
+        QImage image( width, height, QImage::Format_ARGB32_Premultiplied );
+        if( image.isNull() || image.byteCount() != data.size() - headerSize ) return false;
+        if( stream.readRawData( reinterpret_cast<char*>( image.bits() ), image.byteCount() ) != image.byteCount() )
+        { return false; }
+
+        pixmap = QPixmap::fromImage( image );
+        return true;
+
+    }
+
+    //____________________________________________________________________
+    void Helper::insertSharedPixmap( const QString& key, const QPixmap& pixmap ) const
+    {
+
+        if( !_sharedCacheEnabled || pixmap.isNull() ) return;
+
+        // store dimensions and raw ARGB data
+        const QImage image( pixmap.toImage().convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+        QByteArray data;
+        QDataStream stream( &data, QIODevice::WriteOnly );
+        stream << qint32( image.width() ) << qint32( image.height() );
+        stream.writeRawData( reinterpret_cast<const char*>( image.constBits() ), image.byteCount() );
+
+        _sharedCache->insert( _sharedCacheKey + key, data );
+
+    }
+
+    //____________________________________________________________________
+    bool Helper::updateSharedCacheKey( void )
+    {
+
+        // use contrast, color scheme, and style and decoration configuration modification times,
+        // so that entries are invalidated whenever the configuration changes
+        QString colors;
+        const KColorScheme::ColorSet sets[] = { KColorScheme::Window, KColorScheme::Button, KColorScheme::View, KColorScheme::Selection };
+        for( unsigned int i = 0; i < sizeof( sets )/sizeof( sets[0] ); ++i )
+        {
+            const KColorScheme scheme( QPalette::Active, sets[i], _config );
+            colors += scheme.background().color().name();
+            colors += scheme.foreground().color().name();
+            colors += scheme.decoration( KColorScheme::FocusColor ).color().name();
+            colors += scheme.decoration( KColorScheme::HoverColor ).color().name();
+        }
+
+        const QFileInfo styleInfo( KStandardDirs::locateLocal( "config", "oxygenrc" ) );
+        const QFileInfo decorationInfo( KStandardDirs::locateLocal( "config", "kwinrc" ) );
+        const QString key( QString( "%1-%2-%3-%4-" )
+            .arg( _contrast )
+            .arg( qHash( colors ), 0, 16 )
+            .arg( styleInfo.exists() ? styleInfo.lastModified().toTime_t():0 )
+            .arg( decorationInfo.exists() ? decorationInfo.lastModified().toTime_t():0 ) );
+
+        if( key == _sharedCacheKey ) return false;
+        else {
+
+            const bool changed( !_sharedCacheKey.isEmpty() );
+            _sharedCacheKey = key;
+            return changed;
+
+        }
+
     }
 
     //____________________________________________________________________
@@ -165,23 +290,31 @@ namespace Oxygen
         // gradient offset
         const int offset( gradientHeight - 20 );
 
-        // draw upper linear gradient
-        const int splitY( offset + qMin( 300, ( 3*height )/4 ) );
-        const QRect upperRect( -x, -y, r.width(), splitY );
-        QPixmap tile( verticalGradient( color, splitY, offset ) );
-        p->drawTiledPixmap( upperRect, tile );
-
         // draw lower flat part
+        // it is drawn first, since the radial gradient might overlap with it
+        const int splitY( offset + qMin( 300, ( 3*height )/4 ) );
         const QRect lowerRect( -x, splitY-y, r.width(), r.height() - splitY-yShift );
         p->fillRect( lowerRect, backgroundBottomColor( color ) );
 
-        // draw upper radial gradient
+        // draw upper part, composed from linear and radial gradients
         const int radialW( qMin( 600, width ) );
-        const QRect radialRect( ( r.width() - radialW ) / 2-x, -y, radialW, offset + 64 );
-        if ( clipRect.intersects( radialRect ) )
-        {
-            tile = radialGradient( color, radialW, offset + 64 );
-            p->drawPixmap( radialRect, tile );
+        if( isResizing( window ) ) renderResizingWindowBackground( p, QRect( -x, -y, r.width(), splitY ), color, splitY, radialW, offset );
+        else {
+
+            // vertical gradient on both sides, composed band in the middle
+            const int left( -x );
+            const int right( -x + r.width() );
+            const int bandLeft( -x + ( r.width() - radialW )/2 );
+            const int bandRight( bandLeft + radialW );
+            if( bandLeft > left || bandRight < right )
+            {
+                const QPixmap tile( verticalGradient( color, splitY, offset ) );
+                if( bandLeft > left ) p->drawTiledPixmap( QRect( left, -y, bandLeft - left, splitY ), tile );
+                if( bandRight < right ) p->drawTiledPixmap( QRect( bandRight, -y, right - bandRight, splitY ), tile );
+            }
+
+            p->drawPixmap( bandLeft, -y, windowBackgroundBand( color, qMax( splitY, offset + 64 ), splitY, radialW, offset ) );
+
         }
 
         if ( clipRect.isValid() )
@@ -189,6 +322,22 @@ namespace Oxygen
     }
 
 
+    //____________________________________________________________________
+    void Helper::renderResizingWindowBackground( QPainter* p, const QRect& rect, const QColor& color, int splitY, int radialWidth, int offset )
+    {
+
+        // vertical gradient, rendered at maximum height, and stretched
+        const int maxSplitY( offset + 300 );
+        const QPixmap tile( verticalGradient( color, maxSplitY, offset ) );
+        if( offset > 0 ) p->drawPixmap( QRect( rect.left(), rect.top(), rect.width(), offset ), tile, QRect( 0, 0, 1, offset ) );
+        p->drawPixmap( QRect( rect.left(), rect.top() + offset, rect.width(), splitY - offset ), tile, QRect( 0, offset, 1, maxSplitY - offset ) );
+
+        // radial gradient, rendered at maximum width, and stretched
+        const QRect radialRect( rect.left() + ( rect.width() - radialWidth )/2, rect.top(), radialWidth, offset + 64 );
+        p->drawPixmap( radialRect, radialGradient( color, 600, offset + 64 ) );
+
+    }
+
     //____________________________________________________________________
     void Helper::renderBackgroundPixmap( QPainter* p, const QRect& clipRect, const QWidget* widget, const QWidget* window, int yShift, int gradientHeight )
     {
@@ -528,6 +677,39 @@ namespace Oxygen
         return *pixmap;
     }
 
+    //____________________________________________________________________
+    QPixmap Helper::windowBackgroundBand( const QColor& color, int height, int splitY, int radialWidth, int offset )
+    {
+
+        const CacheKey key(
+            ( colorKey( color ) << 32 ) | ( quint64( offset&0xffff ) << 16 ) | quint64( radialWidth&0xffff ),
+            ( quint64( height&0xffff ) << 16 ) | quint64( splitY&0xffff ) );
+
+        QPixmap* pixmap( _windowBackgroundCache.object( key ) );
+        if( !pixmap )
+        {
+
+            pixmap = new QPixmap( radialWidth, height );
+            pixmap->fill( Qt::transparent );
+
+            QPainter p( pixmap );
+
+            // linear gradient
+            p.drawTiledPixmap( QRect( 0, 0, radialWidth, splitY ), verticalGradient( color, splitY, offset ) );
+
+            // radial gradient
+            p.drawPixmap( 0, 0, radialGradient( color, radialWidth, offset + 64 ) );
+
+            p.end();
+
+            _windowBackgroundCache.insert( key, pixmap );
+
+        }
+
+        return *pixmap;
+
+    }
+
     //____________________________________________________________________________________
     const QColor& Helper::decoColor( const QColor& background, const QColor& color )
     {
@@ -546,15 +728,26 @@ namespace Oxygen
     QRegion Helper::roundedMask( const QRect& r, int left, int right, int top, int bottom ) const
     {
         // get rect geometry
-        int x, y, w, h;
-        r.getRect( &x, &y, &w, &h );
+        const int w( r.width() );
+        const int h( r.height() );
 
-        QRegion mask( x + 4*left, y + 0*top, w-4*( left+right ), h-0*( top+bottom ) );
-        mask += QRegion( x + 0*left, y + 4*top, w-0*( left+right ), h-4*( top+bottom ) );
-        mask += QRegion( x + 2*left, y + 1*top, w-2*( left+right ), h-1*( top+bottom ) );
-        mask += QRegion( x + 1*left, y + 2*top, w-1*( left+right ), h-2*( top+bottom ) );
+        const CacheKey key(
+            ( quint64( w ) << 32 ) | quint32( h ),
+            quint8( left ) | ( quint8( right ) << 8 ) | ( quint8( top ) << 16 ) | ( quint64( quint8( bottom ) ) << 24 ) );
 
-        return mask;
+        QRegion* mask( _roundedMaskCache.object( key ) );
+        if( !mask )
+        {
+
+            mask = new QRegion( 4*left, 0*top, w-4*( left+right ), h-0*( top+bottom ) );
+            *mask += QRegion( 0*left, 4*top, w-0*( left+right ), h-4*( top+bottom ) );
+            *mask += QRegion( 2*left, 1*top, w-2*( left+right ), h-1*( top+bottom ) );
+            *mask += QRegion( 1*left, 2*top, w-1*( left+right ), h-2*( top+bottom ) );
+            _roundedMaskCache.insert( key, mask );
+
+        }
+
+        return mask->translated( r.topLeft() );
     }
 
     //______________________________________________________________________
@@ -730,10 +923,8 @@ namespace Oxygen
     //________________________________________________________________________________________________________
     TileSet *Helper::slab( const QColor& color, const QColor& glow, qreal shade, int size )
     {
-        Oxygen::Cache<TileSet>::Value* cache( _slabCache.get( color ) );
-
         const quint64 key( ( colorKey(glow) << 32 ) | ( quint64( 256.0 * shade ) << 24 ) | size );
-        TileSet *tileSet = cache->object( key );
+        TileSet *tileSet = _slabCache.object( color, key );
 
         const qreal hScale( 1 );
         const int hSize( size*hScale );
@@ -741,26 +932,35 @@ namespace Oxygen
 
         if ( !tileSet )
         {
-            QPixmap pixmap( hSize*2,vSize*2 );
-            pixmap.fill( Qt::transparent );
+            QPixmap pixmap;
+            const QString sharedKey( QString( "slab-%1-%2-%3-%4" ).arg( colorKey(color), 0, 16 ).arg( colorKey(glow), 0, 16 ).arg( shade ).arg( size ) );
+            if( !findSharedPixmap( sharedKey, pixmap ) )
+            {
 
-            QPainter p( &pixmap );
-            p.setRenderHints( QPainter::Antialiasing );
-            p.setPen( Qt::NoPen );
+                pixmap = QPixmap( hSize*2,vSize*2 );
+                pixmap.fill( Qt::transparent );
 
-            const int fixedSize( 14 );
-            p.setWindow( 0,0,fixedSize*hScale, fixedSize );
+                QPainter p( &pixmap );
+                p.setRenderHints( QPainter::Antialiasing );
+                p.setPen( Qt::NoPen );
 
-            // draw all components
-            if( color.isValid() ) drawShadow( p, calcShadowColor( color ), 14 );
-            if( glow.isValid() ) drawOuterGlow( p, glow, 14 );
-            if( color.isValid() ) drawSlab( p, color, shade );
+                const int fixedSize( 14 );
+                p.setWindow( 0,0,fixedSize*hScale, fixedSize );
 
-            p.end();
+                // draw all components
+                if( color.isValid() ) drawShadow( p, calcShadowColor( color ), 14 );
+                if( glow.isValid() ) drawOuterGlow( p, glow, 14 );
+                if( color.isValid() ) drawSlab( p, color, shade );
+
+                p.end();
+
+                insertSharedPixmap( sharedKey, pixmap );
+
+            }
 
             tileSet = new TileSet( pixmap, hSize, vSize, hSize, vSize, hSize-1, vSize, 2, 1 );
 
-            cache->insert( key, tileSet );
+            _slabCache.insert( color, key, tileSet );
         }
         return tileSet;
     }
@@ -1091,11 +1291,31 @@ namespace Oxygen
 
         if( !id ) return;
 
+        // skip if value is already set
+        const CacheKey key( id, atom );
+        QHash<CacheKey, HintData>::const_iterator iter( _hints.constFind( key ) );
+        if( iter != _hints.constEnd() && iter.value().isValid( id ) && iter.value()._value == value ) return;
+
         unsigned long uLongValue( value );
         XChangeProperty(
             QX11Info::display(), id, atom, XA_CARDINAL, 32, PropModeReplace,
             reinterpret_cast<const unsigned char *>(&uLongValue), 1 );
 
+        // only windows owned by a widget from this process are stored
+        QWidget* widget( QWidget::find( id ) );
+        if( !widget ) return;
+
+        // remove entries of destroyed windows
+        if( iter == _hints.constEnd() )
+        {
+            for( QHash<CacheKey, HintData>::iterator hintIter = _hints.begin(); hintIter != _hints.end(); )
+            {
+                if( hintIter.value().isValid( hintIter.key().first ) ) ++hintIter;
+                else hintIter = _hints.erase( hintIter );
+            }
+        }
+
+        _hints.insert( key, HintData( widget, value ) );
         return;
     }
 
@@ -1104,6 +1324,10 @@ namespace Oxygen
     {
         if( !id ) return false;
 
+        // use stored value for hints set from this process, to avoid a round trip to the X server
+        QHash<CacheKey, HintData>::const_iterator iter( _hints.constFind( CacheKey( id, atom ) ) );
+        if( iter != _hints.constEnd() && iter.value().isValid( id ) ) return iter.value()._value;
+
         Atom type( None );
         int format(0);
         unsigned char *data(0);
@@ -1117,8 +1341,11 @@ namespace Oxygen
             &data);
 
         // finish if no data is found
-        if( data == None || n != 1 ) return false;
-        else return *data;
+        if( data == None ) return false;
+
+        const bool out( n == 1 && *data );
+        XFree( data );
+        return out;
 
     }
 
@@ -23,130 +23,29 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include "oxygencache.h"
+#include "oxygenresizetracker.h"
 #include "oxygentileset.h"
 
 #include <KSharedConfig>
 #include <KComponentData>
 #include <KColorScheme>
 
+#include <QtCore/QPointer>
 #include <QtGui/QColor>
 #include <QtGui/QPixmap>
 #include <QtGui/QWidget>
 #include <QtGui/QLinearGradient>
-#include <QtCore/QCache>
 
 #ifdef Q_WS_X11
 #include <X11/Xdefs.h>
 #endif
 
+class KSharedDataCache;
+
 namespace Oxygen
 {
 
-    template<typename T> class BaseCache: public QCache<quint64, T>
-    {
-
-        public:
-
-        //! constructor
-        BaseCache( int maxCost ):
-            QCache<quint64, T>( maxCost ),
-            _enabled( true )
-        {}
-
-        //! constructor
-        explicit BaseCache( void ):
-            _enabled( true )
-            {}
-
-        //! destructor
-        ~BaseCache( void )
-        {}
-
-        //! enable
-        void setEnabled( bool value )
-        { _enabled = value; }
-
-        //! enable state
-        bool enabled( void ) const
-        { return _enabled; }
-
-        //! access
-        T* object( const quint64& key )
-        { return _enabled ? QCache<quint64, T>::object( key ) : 0; }
-
-        //! max cost
-        void setMaxCost( int cost )
-        {
-            if( cost <= 0 ) {
-
-                QCache<quint64, T>::clear();
-                QCache<quint64, T>::setMaxCost( 1 );
-                setEnabled( false );
-
-            } else {
-
-                setEnabled( true );
-                QCache<quint64, T>::setMaxCost( cost );
-
-            }
-        }
-
-        private:
-
-        //! enable flag
-        bool _enabled;
-
-    };
-
-    template<typename T> class Cache
-    {
-
-        public:
-
-        //! constructor
-        Cache()
-        {}
-
-        //! destructor
-        ~Cache()
-        {}
-
-        //! return cache matching a given key
-        //typedef QCache<quint64, T> Value;
-        typedef BaseCache<T> Value;
-        Value* get( const QColor& color )
-        {
-            const quint64 key = ( color.isValid() ? color.rgba():0 );
-            Value* cache = data_.object( key );
-
-            if ( !cache )
-            {
-                cache = new Value( data_.maxCost() );
-                data_.insert( key, cache );
-            }
-
-            return cache;
-        }
-
-        //! clear
-        void clear( void )
-        { data_.clear(); }
-
-        //! max cache size
-        void setMaxCacheSize( int value )
-        {
-            data_.setMaxCost( value );
-            foreach( quint64 key, data_.keys() )
-            { data_.object( key )->setMaxCost( value ); }
-        }
-
-        private:
-
-        //! data
-        BaseCache<Value> data_;
-
-    };
-
     //! oxygen style helper class.
     /*! contains utility functions used at multiple places in both oxygen style and oxygen window decoration */
     class OXYGEN_EXPORT Helper
@@ -157,8 +56,7 @@ namespace Oxygen
         explicit Helper( const QByteArray& componentName );
 
         //! destructor
-        virtual ~Helper()
-        {}
+        virtual ~Helper();
 
         //! reload configuration
         virtual void reloadConfig();
@@ -172,6 +70,23 @@ namespace Oxygen
         //! update maximum cache size
         virtual void setMaxCacheSize( int );
 
+        //! update maximum memory used by all caches in the process, in kilobytes
+        /*! a value of zero or less disables the limit */
+        void setMaxCacheMemory( int value )
+        { CacheBudget::instance().setMaxCost( qint64( value )*1024 ); }
+
+        //!@name pixmap cache shared across processes
+        //@{
+
+        //! find pixmap matching key in shared cache. Returns true on success
+        /*! the key is automatically prefixed with a hash of the current configuration */
+        bool findSharedPixmap( const QString&, QPixmap& ) const;
+
+        //! store pixmap in shared cache
+        void insertSharedPixmap( const QString&, const QPixmap& ) const;
+
+        //@}
+
         //!@name window background gradients
         //@{
         /*!
@@ -261,11 +176,25 @@ namespace Oxygen
         //! radial gradient for window background
         virtual QPixmap radialGradient( const QColor& color, int width, int height = 20 );
 
+        //! central part of window background upper band, composed from vertical and radial gradients
+        /*!
+        the band is as wide as the radial gradient, and does not depend on the window width.
+        On both sides, the vertical gradient is tiled horizontally
+        @param height height of the composed band
+        @param splitY height of the vertical gradient. Below, only the radial gradient is drawn
+        @param radialWidth width of the radial gradient, and of the band
+        @param offset gradient offset
+        */
+        virtual QPixmap windowBackgroundBand( const QColor& color, int height, int splitY, int radialWidth, int offset );
+
         //! merge background and front color for check marks, arrows, etc. using _contrast
         virtual const QColor& decoColor( const QColor& background, const QColor& color );
 
         //! returns a region matching given rect, with rounded corners, based on the multipliers
-        /*! setting any of the multipliers to zero will result in no corners shown on the corresponding side */
+        /*!
+        setting any of the multipliers to zero will result in no corners shown on the corresponding side.
+        Regions are cached by size and multipliers, and translated to the rect position on lookup
+        */
         virtual QRegion roundedMask( const QRect&, int left = 1, int right = 1, int top = 1, int bottom = 1 ) const;
 
         //! draw frame that mimics some sort of shadows around a panel
@@ -364,6 +293,22 @@ namespace Oxygen
         //! return background adjusted color matching relative vertical position in window
         const QColor& backgroundColor( const QColor&, qreal ratio );
 
+        //! update shared cache key prefix from current configuration
+        /*! returns true if prefix has changed */
+        bool updateSharedCacheKey( void );
+
+        //! true if window is being resized
+        /*!
+        a window is considered as being resized when its size has changed recently.
+        It is updated once the resize is over
+        */
+        bool isResizing( const QWidget* window )
+        { return _resizeTracker.isResizing( window ); }
+
+        //! render upper part of window background from maximum size gradients
+        /*! it is used while windows are being resized, to avoid rendering and caching gradients at each step */
+        void renderResizingWindowBackground( QPainter*, const QRect&, const QColor&, int splitY, int radialWidth, int offset );
+
         //!@name global configuration parameters
         //@{
 
@@ -420,6 +365,33 @@ namespace Oxygen
         PixmapCache _backgroundCache;
         PixmapCache _dotCache;
 
+        //! composed window backgrounds
+        BaseCache<QPixmap, CacheKey> _windowBackgroundCache;
+
+        //! rounded masks, at origin
+        mutable BaseCache<QRegion, CacheKey> _roundedMaskCache;
+
+        //! resize tracking
+        ResizeTracker _resizeTracker;
+
+        //!@name shared cache
+        //@{
+
+        //! pixmap cache shared across processes
+        /*!
+        it is memory mapped, and stores prerendered ARGB pixmaps,
+        so that starting applications do not need to render them again
+        */
+        KSharedDataCache* _sharedCache;
+
+        //! shared cache enable state
+        bool _sharedCacheEnabled;
+
+        //! shared cache key prefix, matching current configuration
+        QString _sharedCacheKey;
+
+        //@}
+
         //! high threshold colors
         typedef QMap<quint32, bool> ColorMap;
         ColorMap _highThreshold;
@@ -448,6 +420,34 @@ namespace Oxygen
         //! background gradient hint atom
         Atom _backgroundPixmapAtom;
 
+        //! hint set from this process
+        class HintData
+        {
+            public:
+
+            //! constructor
+            explicit HintData( QWidget* widget = 0, bool value = false ):
+                _widget( widget ),
+                _value( value )
+            {}
+
+            //! true if the window still belongs to the widget for which the hint was set
+            /*! window ids of destroyed windows get reused */
+            bool isValid( WId id ) const
+            { return _widget && QWidget::find( id ) == _widget.data(); }
+
+            //! widget owning the window
+            QPointer<QWidget> _widget;
+
+            //! value
+            bool _value;
+
+        };
+
+        //! hints set from this process, indexed by window id and atom
+        /*! it is used to skip redundant property changes, and property queries on own windows */
+        mutable QHash<CacheKey, HintData> _hints;
+
         #endif
     };
 
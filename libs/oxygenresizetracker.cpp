@@ -0,0 +1,106 @@
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygenresizetracker.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace Oxygen
+{
+
+    //____________________________________________________________________
+    bool ResizeTracker::isResizing( const QWidget* window )
+    {
+
+        DataMap::iterator iter( _data.find( window ) );
+        if( iter == _data.end() || !iter.value()._window )
+        {
+
+            // new window, or a deleted one whose address got reused
+            prune();
+            _data.insert( window, Data( const_cast<QWidget*>( window ) ) );
+            return false;
+
+        }
+
+        Data& data( iter.value() );
+        if( window->size() != data._size )
+        {
+
+            // count successive changes
+            if( data._timer.isValid() && !data._timer.hasExpired( _delay ) ) ++data._changes;
+            else data._changes = 1;
+
+            data._size = window->size();
+            data._timer.start();
+            if( data._changes >= _minChanges && !_timer.isActive() ) _timer.start( _delay/3, this );
+
+        }
+
+        // all widgets painted shortly after a size change are considered part of the resize
+        return data._timer.isValid() && data.isResizing();
+
+    }
+
+    //____________________________________________________________________
+    void ResizeTracker::timerEvent( QTimerEvent* event )
+    {
+
+        if( event->timerId() != _timer.timerId() ) return QObject::timerEvent( event );
+
+        bool resizing( false );
+        for( DataMap::iterator iter = _data.begin(); iter != _data.end(); )
+        {
+
+            Data& data( iter.value() );
+            if( !data._window ) { iter = _data.erase( iter ); continue; }
+
+            if( data._timer.isValid() && data._changes >= _minChanges )
+            {
+
+                if( data._timer.hasExpired( _delay ) )
+                {
+
+                    // resize is over. Repaint with the final background
+                    data._timer.invalidate();
+                    data._changes = 0;
+                    data._window.data()->update();
+
+                } else resizing = true;
+
+            }
+
+            ++iter;
+
+        }
+
+        if( !resizing ) _timer.stop();
+
+    }
+
+    //____________________________________________________________________
+    void ResizeTracker::prune( void )
+    {
+        for( DataMap::iterator iter = _data.begin(); iter != _data.end(); )
+        {
+            if( iter.value()._window ) ++iter;
+            else iter = _data.erase( iter );
+        }
+    }
+
+}
@@ -0,0 +1,111 @@
+#ifndef oxygenresizetracker_h
+#define oxygenresizetracker_h
+
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygen_export.h"
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSize>
+#include <QtGui/QWidget>
+
+namespace Oxygen
+{
+
+    //! keep track of window size changes
+    /*!
+    a window is considered as being resized when its size has changed at least twice,
+    with less than a given delay between changes. Single changes, such as maximizing
+    or restoring the window, are ignored. Once the resize is over, the window is updated, so that the background
+    rendered while resizing gets replaced by the final one
+    */
+    class OXYGEN_EXPORT ResizeTracker: public QObject
+    {
+
+        public:
+
+        //! constructor
+        ResizeTracker( void )
+        {}
+
+        //! true if window is being resized
+        bool isResizing( const QWidget* );
+
+        protected:
+
+        //! timer event
+        /*! used to detect the end of resizes */
+        virtual void timerEvent( QTimerEvent* );
+
+        private:
+
+        //! delay after last size change before a resize is considered over (msec)
+        static const int _delay = 300;
+
+        //! number of successive size changes needed to enter resize mode
+        static const int _minChanges = 2;
+
+        //! per window data
+        class Data
+        {
+            public:
+
+            //! constructor
+            explicit Data( QWidget* window = 0 ):
+                _window( window ),
+                _changes( 0 )
+            { if( window ) _size = window->size(); }
+
+            //! true if in resize mode
+            bool isResizing( void ) const
+            { return _changes >= _minChanges && !_timer.hasExpired( _delay ); }
+
+            //! window
+            QPointer<QWidget> _window;
+
+            //! last painted size
+            QSize _size;
+
+            //! number of size changes, separated by less than the delay
+            int _changes;
+
+            //! time since last size change. Invalid before the first change
+            QElapsedTimer _timer;
+
+        };
+
+        //! remove data for deleted windows
+        void prune( void );
+
+        //! per window data
+        typedef QHash<const QWidget*, Data> DataMap;
+        DataMap _data;
+
+        //! timer used to detect the end of resizes
+        QBasicTimer _timer;
+
+    };
+
+}
+
+#endif
@@ -31,22 +31,43 @@
 #include <cassert>
 #include <cmath>
 #include <KColorUtils>
+#include <QtGui/QImage>
 #include <QtGui/QPainter>
 #include <QtCore/QTextStream>
+#include <QtCore/QtConcurrentRun>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace Oxygen
 {
 
     //_______________________________________________________
     ShadowCache::ShadowCache( Helper& helper ):
-        _helper( helper )
+        _helper( helper ),
+        _interpolationEnabled( false ),
+        _prewarmEnabled( false )
     {
 
+        // cache names, used for statistics
+        _shadowCache.setName( "shadow" );
+        _animatedShadowCache.setName( "animatedShadow" );
+
         setEnabled( true );
         setMaxIndex( 256 );
 
     }
 
+    //_______________________________________________________
+    ShadowCache::~ShadowCache( void )
+    {
+        // make sure no worker thread is still running when the library gets unloaded
+        cancelPrewarmJobs();
+        foreach( const PrewarmJobPointer& job, _canceledPrewarmJobs )
+        { job->future.waitForFinished(); }
+    }
+
     //_______________________________________________________
     void ShadowCache::readConfig( void )
     {
@@ -116,7 +137,11 @@ namespace Oxygen
 
         // check if tileSet already in cache
         int hash( key.hash() );
-        if( _enabled && _shadowCache.contains(hash) ) return _shadowCache.object(hash);
+        if( _enabled )
+        {
+            TileSet* tileSet( _shadowCache.object( hash ) );
+            if( tileSet ) return tileSet;
+        }
 
         // create tileSet otherwise
         qreal size( shadowSize() + overlap );
@@ -135,45 +160,234 @@ namespace Oxygen
         assert( index <= _maxIndex );
 
         // construct key
+        // animated shadows do not depend on the active state
         key.index = index;
+        key.active = false;
 
         // check if tileSet already in cache
         int hash( key.hash() );
-        if( _enabled && _animatedShadowCache.contains(hash) ) return _animatedShadowCache.object(hash);
+        if( _enabled )
+        {
+            TileSet* tileSet( _animatedShadowCache.object( hash ) );
+            if( tileSet ) return tileSet;
+
+            // check background rendered frames
+            if( _prewarmEnabled && ( tileSet = prewarmedTileSet( key ) ) )
+            { return tileSet; }
+
+        }
 
         // create shadow and tileset otherwise
         qreal size( shadowSize() + overlap );
 
-        QPixmap shadow( size*2, size*2 );
-        shadow.fill( Qt::transparent );
-        QPainter p( &shadow );
-        p.setRenderHint( QPainter::Antialiasing );
+        const QImage shadow( animatedFrame( pixmap( key, false ).toImage(), pixmap( key, true ).toImage(), opacity, size*2 ) );
+        TileSet* tileSet = new TileSet( QPixmap::fromImage( shadow ), size, size, 1, 1 );
+        _animatedShadowCache.insert( hash, tileSet );
+        return tileSet;
+
+    }
+
+    //_______________________________________________________
+    void ShadowCache::render( Key key, qreal opacity, const QRect& rect, QPainter* painter, TileSet::Tiles tiles )
+    {
 
-        QPixmap inactiveShadow( pixmap( key, false ) );
-        if( !inactiveShadow.isNull() )
+        if( !_interpolationEnabled )
         {
-            QPainter pp( &inactiveShadow );
-            pp.setRenderHint( QPainter::Antialiasing );
-            pp.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-            pp.fillRect( inactiveShadow.rect(), QColor( 0, 0, 0, 255*(1.0-opacity ) ) );
+            tileSet( key, opacity )->render( rect, painter, tiles );
+            return;
         }
 
-        QPixmap activeShadow( pixmap( key, true ) );
-        if( !activeShadow.isNull() )
+        // cross-fade inactive and active shadows
+        const qreal oldOpacity( painter->opacity() );
+        key.index = 0;
+
+        if( opacity < 1.0 )
         {
-            QPainter pp( &activeShadow );
-            pp.setRenderHint( QPainter::Antialiasing );
-            pp.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-            pp.fillRect( activeShadow.rect(), QColor( 0, 0, 0, 255*( opacity ) ) );
+            key.active = false;
+            painter->setOpacity( oldOpacity*( 1.0 - opacity ) );
+            tileSet( key )->render( rect, painter, tiles );
         }
 
-        p.drawPixmap( QPointF(0,0), inactiveShadow );
-        p.drawPixmap( QPointF(0,0), activeShadow );
-        p.end();
+        if( opacity > 0 )
+        {
+            key.active = true;
+            painter->setOpacity( oldOpacity*opacity );
+            tileSet( key )->render( rect, painter, tiles );
+        }
 
-        TileSet* tileSet = new TileSet(shadow, size, size, 1, 1);
-        _animatedShadowCache.insert( hash, tileSet );
-        return tileSet;
+        painter->setOpacity( oldOpacity );
+
+    }
+
+    //_______________________________________________________
+    void ShadowCache::prewarm( Key key )
+    {
+
+        if( !( _prewarmEnabled && _enabled && !_interpolationEnabled && isEnabled( QPalette::Active ) ) ) return;
+
+        // jobs are stored with zero index
+        key.index = 0;
+        key.active = false;
+        const int hash( key.hash() );
+        if( _prewarmJobs.contains( hash ) || _finishedPrewarmJobs.contains( hash ) ) return;
+
+        // shadow pixmaps depend on configuration, and are therefore rendered in the GUI thread
+        const QImage inactive( pixmap( key, false ).toImage() );
+        const QImage active( pixmap( key, true ).toImage() );
+        const int size( 2*( shadowSize() + overlap ) );
+
+        // frames held by the job are charged to the cache budget
+        PrewarmJobPointer job( new PrewarmJob() );
+        job->cost = qint64( _maxIndex + 1 )*size*size*4;
+        CacheBudget::instance().addCost( job->cost );
+
+        job->future = QtConcurrent::run( &ShadowCache::runPrewarmJob, job, inactive, active, _maxIndex, size );
+        _prewarmJobs.insert( hash, job );
+
+    }
+
+    //_______________________________________________________
+    void ShadowCache::runPrewarmJob( PrewarmJobPointer job, QImage inactive, QImage active, int maxIndex, int size )
+    {
+
+        for( int index = 0; index <= maxIndex && !int( job->canceled ); ++index )
+        {
+            const qreal opacity( maxIndex > 0 ? qreal( index )/maxIndex : 0 );
+            const QImage frame( animatedFrame( inactive, active, opacity, size ) );
+
+            QMutexLocker locker( &job->mutex );
+            job->frames.insert( index, frame );
+        }
+
+    }
+
+    //_______________________________________________________
+    TileSet* ShadowCache::prewarmedTileSet( Key key )
+    {
+
+        // find job, start one if needed
+        const int index( key.index );
+        key.index = 0;
+        QHash<int, PrewarmJobPointer>::const_iterator iter( _prewarmJobs.constFind( key.hash() ) );
+        if( iter == _prewarmJobs.constEnd() )
+        {
+            prewarm( key );
+            iter = _prewarmJobs.constFind( key.hash() );
+            if( iter == _prewarmJobs.constEnd() ) return 0;
+        }
+
+        // check if frame is ready
+        key.index = index;
+        const PrewarmJobPointer job( iter.value() );
+        const QImage image( job->take( index ) );
+        if( !image.isNull() )
+        {
+            // frame is now charged through the tileset cache
+            const qint64 frameCost( qint64( image.width() )*image.height()*4 );
+            job->cost -= frameCost;
+            CacheBudget::instance().addCost( -frameCost );
+
+            const qreal size( shadowSize() + overlap );
+            TileSet* tileSet = new TileSet( QPixmap::fromImage( image ), size, size, 1, 1 );
+            _animatedShadowCache.insert( key.hash(), tileSet );
+            return tileSet;
+        }
+
+        // frames that are evicted after the job is done are rendered synchronously
+        if( job->future.isFinished() )
+        {
+
+            // drop job once all its frames have been taken
+            bool empty( false );
+            {
+                QMutexLocker locker( &job->mutex );
+                empty = job->frames.isEmpty();
+            }
+
+            if( empty )
+            {
+                key.index = 0;
+                releaseCost( job );
+                _prewarmJobs.remove( key.hash() );
+                _finishedPrewarmJobs.insert( key.hash() );
+            }
+
+            return 0;
+
+        }
+
+        // use closest cached frame
+        for( int offset = 1; offset <= _maxIndex; ++offset )
+        {
+            Key closest( key );
+            closest.index = index - offset;
+            if( closest.index >= 0 && _animatedShadowCache.contains( closest.hash() ) )
+            { return _animatedShadowCache.object( closest.hash() ); }
+
+            closest.index = index + offset;
+            if( closest.index <= _maxIndex && _animatedShadowCache.contains( closest.hash() ) )
+            { return _animatedShadowCache.object( closest.hash() ); }
+        }
+
+        // use static shadow otherwise
+        Key endpoint( key );
+        endpoint.index = 0;
+        endpoint.active = ( 2*index > _maxIndex );
+        return tileSet( endpoint );
+
+    }
+
+    //_______________________________________________________
+    void ShadowCache::cancelPrewarmJobs( void )
+    {
+        // forget canceled jobs that are done
+        for( QList<PrewarmJobPointer>::iterator iter = _canceledPrewarmJobs.begin(); iter != _canceledPrewarmJobs.end(); )
+        {
+            if( (*iter)->future.isFinished() ) iter = _canceledPrewarmJobs.erase( iter );
+            else ++iter;
+        }
+
+        // running jobs are not waited for, but kept until done, so that the destructor can wait for them
+        foreach( const PrewarmJobPointer& job, _prewarmJobs )
+        {
+            job->canceled = 1;
+            releaseCost( job );
+            if( !job->future.isFinished() ) _canceledPrewarmJobs.append( job );
+        }
+
+        _prewarmJobs.clear();
+        _finishedPrewarmJobs.clear();
+    }
+
+    //_______________________________________________________
+    void ShadowCache::releaseCost( const PrewarmJobPointer& job )
+    {
+        if( !CacheBudget::isDestroyed() ) CacheBudget::instance().addCost( -job->cost );
+        job->cost = 0;
+    }
+
+    //_______________________________________________________
+    QImage ShadowCache::animatedFrame( const QImage& inactive, const QImage& active, qreal opacity, int size )
+    {
+
+        QImage frame( size, size, QImage::Format_ARGB32_Premultiplied );
+        frame.fill( 0 );
+
+        QPainter p( &frame );
+        if( !inactive.isNull() )
+        {
+            p.setOpacity( 1.0 - opacity );
+            p.drawImage( QPointF( 0, 0 ), inactive );
+        }
+
+        if( !active.isNull() )
+        {
+            p.setOpacity( opacity );
+            p.drawImage( QPointF( 0, 0 ), active );
+        }
+
+        p.end();
+        return frame;
 
     }
 
@@ -194,16 +408,18 @@ namespace Oxygen
         size += overlap;
         shadowSize += overlap;
 
-        QPixmap shadow = QPixmap( size*2, size*2 );
-        shadow.fill( Qt::transparent );
-
-        QPainter p( &shadow );
-        p.setRenderHint( QPainter::Antialiasing );
-        p.setPen( Qt::NoPen );
-
         // some gradients rendering are different at bottom corners if client has no border
         bool hasBorder( key.hasBorder || key.isShade );
 
+        // check shared cache
+        QPixmap shadow;
+        const QString sharedKey( this->sharedKey( active, hasBorder, size, shadowSize ) );
+        if( helper().findSharedPixmap( sharedKey, shadow ) ) return shadow;
+
+        // gradients are rasterized directly into an image, rather than using QPainter
+        QImage image( size*2, size*2, QImage::Format_ARGB32_Premultiplied );
+        image.fill( 0 );
+
         if( active )
         {
 
@@ -228,8 +444,7 @@ namespace Oxygen
 
                 }
 
-                p.setBrush( rg );
-                renderGradient( p, shadow.rect(), rg, hasBorder );
+                renderGradient( image, rg, hasBorder );
 
             }
 
@@ -254,8 +469,7 @@ namespace Oxygen
 
                 }
 
-                p.setBrush( rg );
-                p.drawRect( shadow.rect() );
+                renderGradient( image, rg, true );
 
             }
 
@@ -282,8 +496,7 @@ namespace Oxygen
                 }
 
 
-                p.setBrush( rg );
-                renderGradient( p, shadow.rect(), rg, hasBorder );
+                renderGradient( image, rg, hasBorder );
 
             }
 
@@ -308,8 +521,7 @@ namespace Oxygen
 
                 }
 
-                p.setBrush( rg );
-                p.drawRect( shadow.rect() );
+                renderGradient( image, rg, true );
 
             }
 
@@ -333,23 +545,239 @@ namespace Oxygen
                     rg.setColorAt( x, c );
                 }
 
-                p.setBrush( rg );
-                p.drawRect( shadow.rect() );
+                renderGradient( image, rg, true );
 
             }
 
         }
 
         // mask
-        p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-        p.setBrush( Qt::black );
-        p.drawEllipse( QRectF( size-3, size-3, 6, 6 ) );
+        {
+            QPainter p( &image );
+            p.setRenderHint( QPainter::Antialiasing );
+            p.setPen( Qt::NoPen );
+            p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+            p.setBrush( Qt::black );
+            p.drawEllipse( QRectF( size-3, size-3, 6, 6 ) );
+        }
 
-        p.end();
+        shadow = QPixmap::fromImage( image );
+
+        // store in shared cache
+        helper().insertSharedPixmap( sharedKey, shadow );
         return shadow;
 
     }
 
+    //_______________________________________________________
+    QString ShadowCache::sharedKey( bool active, bool hasBorder, qreal size, qreal shadowSize ) const
+    {
+
+        QString out;
+        QTextStream stream( &out );
+        stream << "shadow-" << active << "-" << hasBorder << "-" << size << "-" << shadowSize << "-";
+        if( active )
+        {
+
+            stream
+                << ActiveShadowConfiguration::verticalOffset() << "-"
+                << ActiveShadowConfiguration::innerColor().name() << "-"
+                << ActiveShadowConfiguration::useOuterColor() << "-"
+                << ActiveShadowConfiguration::outerColor().name();
+
+        } else {
+
+            stream
+                << InactiveShadowConfiguration::verticalOffset() << "-"
+                << InactiveShadowConfiguration::innerColor().name() << "-"
+                << InactiveShadowConfiguration::useOuterColor() << "-"
+                << InactiveShadowConfiguration::outerColor().name();
+
+        }
+
+        stream.flush();
+        return out;
+
+    }
+
+    //_______________________________________________________
+    void ShadowCache::renderGradient( QImage& image, const QRadialGradient& rg, bool hasBorder ) const
+    {
+
+        if( hasBorder )
+        {
+            rasterizeGradient( image, rg );
+            return;
+        }
+
+        // bottom corners are rendered with QPainter
+        QPainter p( &image );
+        p.setRenderHint( QPainter::Antialiasing );
+        p.setPen( Qt::NoPen );
+        renderGradient( p, image.rect(), rg, false );
+
+    }
+
+    //_______________________________________________________
+    //! source over composition of premultiplied pixels
+    /*! it matches the integer arithmetics of the SSE2 version */
+    static inline quint32 sourceOver( quint32 source, quint32 destination )
+    {
+        const quint32 alpha( 255 - ( source >> 24 ) );
+        quint32 out( 0 );
+        for( int shift = 0; shift < 32; shift += 8 )
+        {
+            quint32 value( ( ( destination >> shift )&0xff )*alpha + 128 );
+            value = ( value + ( value >> 8 ) ) >> 8;
+            out |= qMin<quint32>( 255, ( ( source >> shift )&0xff ) + value ) << shift;
+        }
+
+        return out;
+    }
+
+    //_______________________________________________________
+    void ShadowCache::gradientTable( const QGradientStops& stops, quint32* table )
+    {
+
+        if( stops.isEmpty() )
+        {
+            for( int i = 0; i < gradientTableSize; ++i ) table[i] = 0;
+            return;
+        }
+
+        // premultiplied stop colors
+        QVector<qreal> colors( 4*stops.size() );
+        for( int i = 0; i < stops.size(); ++i )
+        {
+            const QColor& color( stops[i].second );
+            const qreal alpha( color.alphaF() );
+            colors[4*i] = color.blueF()*alpha;
+            colors[4*i+1] = color.greenF()*alpha;
+            colors[4*i+2] = color.redF()*alpha;
+            colors[4*i+3] = alpha;
+        }
+
+        // colors are interpolated in premultiplied space, as done by QPainter
+        int stop( 0 );
+        for( int i = 0; i < gradientTableSize; ++i )
+        {
+
+            const qreal position( qreal( i )/( gradientTableSize - 1 ) );
+            while( stop < stops.size() - 1 && stops[stop+1].first < position ) ++stop;
+
+            int first( stop );
+            int second( stop );
+            qreal ratio( 0 );
+            if( position <= stops.first().first ) first = second = 0;
+            else if( position >= stops.last().first ) first = second = stops.size()-1;
+            else {
+                second = stop+1;
+                ratio = ( position - stops[first].first )/( stops[second].first - stops[first].first );
+            }
+
+            quint32 value( 0 );
+            for( int channel = 0; channel < 4; ++channel )
+            {
+                const qreal color( colors[4*first+channel]*( 1.0 - ratio ) + colors[4*second+channel]*ratio );
+                value |= quint32( qBound( 0, qRound( 255*color ), 255 ) ) << ( 8*channel );
+            }
+
+            table[i] = value;
+
+        }
+
+    }
+
+    //_______________________________________________________
+    void ShadowCache::rasterizeGradient( QImage& image, const QRadialGradient& rg )
+    {
+
+        quint32 table[gradientTableSize];
+        gradientTable( rg.stops(), table );
+
+        const qreal radius( rg.radius() );
+        if( radius <= 0 ) return;
+
+        const qreal scale( ( gradientTableSize - 1 )/radius );
+        const qreal cx( rg.center().x() );
+        const qreal cy( rg.center().y() );
+
+        // when the last color is transparent, only pixels inside the gradient radius need to be painted
+        const bool clip( table[gradientTableSize-1] == 0 );
+
+        const int width( image.width() );
+        for( int y = 0; y < image.height(); ++y )
+        {
+
+            const qreal dy( y + 0.5 - cy );
+            int xMin( 0 );
+            int xMax( width );
+            if( clip )
+            {
+                if( qAbs( dy ) >= radius ) continue;
+                const qreal dx( std::sqrt( radius*radius - dy*dy ) );
+                xMin = qMax( 0, int( std::floor( cx - dx ) ) );
+                xMax = qMin( width, int( std::ceil( cx + dx ) ) );
+            }
+
+            quint32* line( reinterpret_cast<quint32*>( image.scanLine( y ) ) );
+            int x( xMin );
+
+            #ifdef __SSE2__
+            {
+                const __m128 offsets( _mm_set_ps( 3, 2, 1, 0 ) );
+                const __m128 dy2( _mm_set1_ps( dy*dy ) );
+                const __m128 scale4( _mm_set1_ps( scale ) );
+                const __m128 half( _mm_set1_ps( 0.5 ) );
+                const __m128 maxIndex( _mm_set1_ps( gradientTableSize - 1 ) );
+                const __m128i zero( _mm_setzero_si128() );
+                const __m128i opaque( _mm_set1_epi32( 255 ) );
+                const __m128i round( _mm_set1_epi16( 128 ) );
+
+                for( ; x + 4 <= xMax; x += 4 )
+                {
+
+                    // table index
+                    const __m128 dx( _mm_add_ps( _mm_set1_ps( x + 0.5 - cx ), offsets ) );
+                    const __m128 distance( _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), dy2 ) ) );
+                    const __m128 position( _mm_min_ps( _mm_add_ps( _mm_mul_ps( distance, scale4 ), half ), maxIndex ) );
+
+                    int indices[4];
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( indices ), _mm_cvttps_epi32( position ) );
+                    const __m128i source( _mm_set_epi32( table[indices[3]], table[indices[2]], table[indices[1]], table[indices[0]] ) );
+
+                    // inverse source alpha, replicated on each 16 bits channel
+                    __m128i alpha( _mm_sub_epi32( opaque, _mm_srli_epi32( source, 24 ) ) );
+                    alpha = _mm_or_si128( alpha, _mm_slli_epi32( alpha, 16 ) );
+
+                    // destination times inverse alpha, divided by 255
+                    const __m128i destination( _mm_loadu_si128( reinterpret_cast<const __m128i*>( line + x ) ) );
+                    __m128i low( _mm_mullo_epi16( _mm_unpacklo_epi8( destination, zero ), _mm_shuffle_epi32( alpha, _MM_SHUFFLE( 1, 1, 0, 0 ) ) ) );
+                    __m128i high( _mm_mullo_epi16( _mm_unpackhi_epi8( destination, zero ), _mm_shuffle_epi32( alpha, _MM_SHUFFLE( 3, 3, 2, 2 ) ) ) );
+                    low = _mm_add_epi16( low, round );
+                    high = _mm_add_epi16( high, round );
+                    low = _mm_srli_epi16( _mm_add_epi16( low, _mm_srli_epi16( low, 8 ) ), 8 );
+                    high = _mm_srli_epi16( _mm_add_epi16( high, _mm_srli_epi16( high, 8 ) ), 8 );
+
+                    // add source
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( line + x ), _mm_adds_epu8( source, _mm_packus_epi16( low, high ) ) );
+
+                }
+            }
+            #endif
+
+            // remaining pixels
+            for( ; x < xMax; ++x )
+            {
+                const qreal dx( x + 0.5 - cx );
+                const int index( qMin<qreal>( std::sqrt( dx*dx + dy*dy )*scale + 0.5, gradientTableSize - 1 ) );
+                line[x] = sourceOver( table[index], line[x] );
+            }
+
+        }
+
+    }
+
     //_______________________________________________________
     void ShadowCache::renderGradient( QPainter& p, const QRectF& rect, const QRadialGradient& rg, bool hasBorder ) const
     {
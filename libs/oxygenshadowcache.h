@@ -30,7 +30,14 @@
 #include "oxygenhelper.h"
 #include "oxygen_export.h"
 
-#include <QtCore/QCache>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFuture>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
 #include <QtGui/QRadialGradient>
 #include <cmath>
 
@@ -41,12 +48,15 @@ namespace Oxygen
     {
         public:
 
+        //! defines overlap between shadows and body
+        /*! it is public so that the decoration can account for it when testing damaged regions */
+        enum { overlap = 4 };
+
         //! constructor
         explicit ShadowCache( Helper& );
 
         //! destructor
-        virtual ~ShadowCache( void )
-        {}
+        virtual ~ShadowCache( void );
 
         //! read configuration
         void readConfig( void );
@@ -93,10 +103,35 @@ namespace Oxygen
         //! invalidate caches
         void invalidateCaches( void )
         {
+            cancelPrewarmJobs();
             _shadowCache.clear();
             _animatedShadowCache.clear();
         }
 
+        //! interpolated animated shadows
+        /*!
+        when enabled, only inactive and active shadows are cached,
+        and animation frames are rendered by cross-fading the two
+        */
+        void setInterpolationEnabled( bool value )
+        {
+            if( _interpolationEnabled == value ) return;
+            _interpolationEnabled = value;
+            invalidateCaches();
+        }
+
+        //! interpolated animated shadows
+        bool interpolationEnabled( void ) const
+        { return _interpolationEnabled; }
+
+        //! background rendering of animated shadows
+        void setPrewarmEnabled( bool value )
+        { _prewarmEnabled = value; }
+
+        //! background rendering of animated shadows
+        bool prewarmEnabled( void ) const
+        { return _prewarmEnabled; }
+
         //! true if shadow is enabled for a given group
         bool isEnabled( QPalette::ColorGroup ) const;
 
@@ -152,8 +187,20 @@ namespace Oxygen
         TileSet* tileSet( const Key& );
 
         //! get shadow matching client and opacity
+        /*!
+        when background rendering is enabled, and the matching frame is not ready yet,
+        the closest available frame is returned rather than rendering it synchronously
+        */
         TileSet* tileSet( Key, qreal );
 
+        //! render all animation frames for a given key in a background thread
+        /*! it does nothing unless background rendering is enabled, and interpolation disabled */
+        void prewarm( Key );
+
+        //! render shadow matching client and opacity
+        /*! depending on interpolation mode, either the matching animation frame or a cross-fade of inactive and active shadows is used */
+        void render( Key, qreal opacity, const QRect&, QPainter*, TileSet::Tiles = TileSet::Ring );
+
         //! simple pixmap
         QPixmap pixmap( const Key& key ) const
         { return pixmap( key, key.active ); }
@@ -226,14 +273,40 @@ namespace Oxygen
         /*! a separate method is used in order to properly account for corners */
         void renderGradient( QPainter&, const QRectF&, const QRadialGradient&, bool hasBorder = true ) const;
 
+        //! draw gradient into image
+        /*! the gradient is rasterized directly when covering the full image, and painted with QPainter otherwise */
+        void renderGradient( QImage&, const QRadialGradient&, bool hasBorder ) const;
+
+        //! size of the color table used for rasterizing gradients, same as QPainter's
+        enum { gradientTableSize = 1024 };
+
+        //! compute premultiplied color table from gradient stops
+        static void gradientTable( const QGradientStops&, quint32* );
+
+        //! composite radial gradient over the full image, which must use premultiplied ARGB32 format
+        /*! pixels are evaluated analytically, and four at a time when SSE2 is available */
+        static void rasterizeGradient( QImage&, const QRadialGradient& );
+
+        //! animation frame, blending inactive and active shadows
+        /*! only QImage is used, so that it can run outside of the GUI thread */
+        static QImage animatedFrame( const QImage& inactive, const QImage& active, qreal opacity, int size );
+
+        //! tileset from background rendered frames
+        /*! returns zero if the frame must be rendered synchronously */
+        TileSet* prewarmedTileSet( Key );
+
+        //! cancel running background jobs
+        void cancelPrewarmJobs( void );
+
+        //! key used to store shadow pixmaps in the helper's shared cache
+        /*! it includes all configuration parameters the rendering depends on */
+        QString sharedKey( bool active, bool hasBorder, qreal size, qreal shadowSize ) const;
+
         private:
 
         //! helper
         Helper& _helper;
 
-        //! defines overlap between shadows and body
-        enum { overlap = 4 };
-
         //! caching enable state
         bool _enabled;
 
@@ -242,7 +315,7 @@ namespace Oxygen
         int _maxIndex;
 
         //! cache
-        typedef QCache<int, TileSet> TileSetCache;
+        typedef BaseCache<TileSet> TileSetCache;
 
         //! shadow cache
         TileSetCache _shadowCache;
@@ -250,6 +323,68 @@ namespace Oxygen
         //! animated shadow cache
         TileSetCache _animatedShadowCache;
 
+        //! animation frames rendered in a background thread
+        class PrewarmJob
+        {
+
+            public:
+
+            //! constructor
+            PrewarmJob( void ):
+                canceled( 0 ),
+                cost( 0 )
+            {}
+
+            //! take frame matching index, if rendered
+            QImage take( int index )
+            {
+                QMutexLocker locker( &mutex );
+                return frames.take( index );
+            }
+
+            //! set to non zero to stop rendering
+            QAtomicInt canceled;
+
+            //! protects frames
+            QMutex mutex;
+
+            //! rendered frames, indexed by animation index
+            QHash<int, QImage> frames;
+
+            //! future
+            QFuture<void> future;
+
+            //! memory charged to the cache budget for frames not taken yet
+            /*! it is only accessed from the GUI thread */
+            qint64 cost;
+
+        };
+
+        //! shared pointer to job, kept alive by the worker thread until done
+        typedef QSharedPointer<PrewarmJob> PrewarmJobPointer;
+
+        //! render all animation frames. Runs in a worker thread
+        static void runPrewarmJob( PrewarmJobPointer, QImage inactive, QImage active, int maxIndex, int size );
+
+        //! remove remaining job cost from the cache budget
+        static void releaseCost( const PrewarmJobPointer& );
+
+        //! interpolation enable state
+        bool _interpolationEnabled;
+
+        //! background rendering enable state
+        bool _prewarmEnabled;
+
+        //! background jobs, indexed by key hash, with zero index
+        QHash<int, PrewarmJobPointer> _prewarmJobs;
+
+        //! key hashes of jobs that are done, and whose frames have all been taken
+        QSet<int> _finishedPrewarmJobs;
+
+        //! canceled jobs, possibly still running
+        /*! they are waited for on destruction */
+        QList<PrewarmJobPointer> _canceledPrewarmJobs;
+
     };
 
 }
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygentileatlas.h"
+#include "oxygencache.h"
+
+namespace Oxygen
+{
+
+    //____________________________________________________________________
+    TileAtlasRegion::TileAtlasRegion( TileAtlasPage* page, const QRect& rect ):
+        _page( page ),
+        _rect( rect )
+    {}
+
+    //____________________________________________________________________
+    TileAtlasRegion::~TileAtlasRegion( void )
+    { TileAtlas::instance().release( _page, _rect ); }
+
+    //____________________________________________________________________
+    QPixmap& TileAtlasRegion::pixmap( void ) const
+    { return _page->pixmap(); }
+
+    //____________________________________________________________________
+    TileAtlas& TileAtlas::instance( void )
+    {
+        // the atlas is never deleted on purpose, since cached tilesets
+        // might be destroyed after static objects, on library unload
+        static TileAtlas* atlas = new TileAtlas();
+        return *atlas;
+    }
+
+    //____________________________________________________________________
+    TileAtlasHandle TileAtlas::allocate( const QSize& size )
+    {
+
+        if( size.isEmpty() ) return TileAtlasHandle();
+
+        // try existing pages, most recent first
+        QRect rect;
+        for( int i = _pages.size() - 1; i >= 0; --i )
+        {
+            if( _pages[i]->allocate( size, rect ) )
+            { return TileAtlasHandle( new TileAtlasRegion( _pages[i], rect ) ); }
+        }
+
+        // create new page, large enough to hold the region
+        TileAtlasPage* page( new TileAtlasPage( size.expandedTo( QSize( pageSize, pageSize ) ) ) );
+        _pages.append( page );
+        CacheBudget::instance().addCost( page->cost() );
+        page->allocate( size, rect );
+        return TileAtlasHandle( new TileAtlasRegion( page, rect ) );
+
+    }
+
+    //____________________________________________________________________
+    void TileAtlas::release( TileAtlasPage* page, const QRect& rect )
+    {
+        if( page->release( rect ) )
+        {
+            _pages.removeAll( page );
+            if( !CacheBudget::isDestroyed() ) CacheBudget::instance().addCost( -page->cost() );
+            delete page;
+        }
+    }
+
+    //____________________________________________________________________
+    TileAtlasPage::TileAtlasPage( const QSize& size ):
+        _pixmap( size ),
+        _height( 0 ),
+        _count( 0 )
+    { _pixmap.fill( Qt::transparent ); }
+
+    //____________________________________________________________________
+    bool TileAtlasPage::allocate( const QSize& size, QRect& rect )
+    {
+
+        if( size.width() > _pixmap.width() ) return false;
+
+        // find the smallest released rectangle large enough
+        int best( -1 );
+        for( int i = 0; i < _freeRects.size(); ++i )
+        {
+            const QRect& free( _freeRects[i] );
+            if( free.width() < size.width() || free.height() < size.height() ) continue;
+            if( best < 0 || free.width()*free.height() < _freeRects[best].width()*_freeRects[best].height() )
+            { best = i; }
+        }
+
+        if( best >= 0 )
+        {
+
+            // split remaining space into right and bottom rectangles
+            const QRect free( _freeRects.takeAt( best ) );
+            const QRect right( free.left() + size.width(), free.top(), free.width() - size.width(), size.height() );
+            const QRect bottom( free.left(), free.top() + size.height(), free.width(), free.height() - size.height() );
+            if( !right.isEmpty() ) _freeRects.append( right );
+            if( !bottom.isEmpty() ) _freeRects.append( bottom );
+
+            rect = QRect( free.topLeft(), size );
+            ++_count;
+            return true;
+
+        }
+
+        // find a shelf with enough room, and not wasting too much height
+        for( int i = 0; i < _shelves.size(); ++i )
+        {
+
+            Shelf& shelf( _shelves[i] );
+            if( shelf.height < size.height() || 2*shelf.height > 3*size.height() ) continue;
+            if( shelf.width + size.width() > _pixmap.width() ) continue;
+
+            rect = QRect( QPoint( shelf.width, shelf.y ), size );
+            shelf.width += size.width();
+
+            // space left below the rectangle is available for reuse
+            const QRect bottom( rect.left(), rect.bottom() + 1, size.width(), shelf.height - size.height() );
+            if( !bottom.isEmpty() ) _freeRects.append( bottom );
+
+            ++_count;
+            return true;
+
+        }
+
+        // create new shelf
+        if( _height + size.height() > _pixmap.height() ) return false;
+        Shelf shelf( _height, size.height() );
+        shelf.width = size.width();
+        _shelves.append( shelf );
+        _height += size.height();
+
+        rect = QRect( QPoint( 0, shelf.y ), size );
+        ++_count;
+        return true;
+
+    }
+
+    //____________________________________________________________________
+    bool TileAtlasPage::release( const QRect& rect )
+    {
+        if( --_count <= 0 ) return true;
+
+        // merge with free neighbours sharing a full edge
+        QRect merged( rect );
+        for( bool found = true; found; )
+        {
+            found = false;
+            for( int i = 0; i < _freeRects.size(); ++i )
+            {
+                const QRect& free( _freeRects[i] );
+                const bool horizontal( free.top() == merged.top() && free.height() == merged.height() &&
+                    ( free.right() + 1 == merged.left() || merged.right() + 1 == free.left() ) );
+                const bool vertical( free.left() == merged.left() && free.width() == merged.width() &&
+                    ( free.bottom() + 1 == merged.top() || merged.bottom() + 1 == free.top() ) );
+                if( !( horizontal || vertical ) ) continue;
+
+                merged |= free;
+                _freeRects.removeAt( i );
+                found = true;
+                break;
+            }
+        }
+
+        _freeRects.append( merged );
+
+        // give back free space at the end of shelves
+        for( bool found = true; found; )
+        {
+            found = false;
+            for( int i = 0; i < _shelves.size() && !found; ++i )
+            {
+                Shelf& shelf( _shelves[i] );
+                for( int j = 0; j < _freeRects.size(); ++j )
+                {
+                    const QRect& free( _freeRects[j] );
+                    if( free.top() != shelf.y || free.height() != shelf.height || free.right() + 1 != shelf.width ) continue;
+
+                    shelf.width = free.left();
+                    _freeRects.removeAt( j );
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        // remove empty shelves at the bottom of the page
+        while( !_shelves.isEmpty() && _shelves.last().width == 0 )
+        {
+            _height -= _shelves.last().height;
+            _shelves.removeLast();
+        }
+
+        // drop free space that now lies past the last shelf
+        for( int i = _freeRects.size() - 1; i >= 0; --i )
+        {
+            QRect& free( _freeRects[i] );
+            if( free.bottom() >= _height ) free.setBottom( _height - 1 );
+            if( free.isEmpty() ) _freeRects.removeAt( i );
+        }
+
+        return false;
+    }
+
+}
@@ -0,0 +1,184 @@
+#ifndef oxygentileatlas_h
+#define oxygentileatlas_h
+
+/*
+ * Copyright 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License version 2 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "oxygen_export.h"
+
+#include <QtCore/QList>
+#include <QtCore/QRect>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QPixmap>
+
+namespace Oxygen
+{
+
+    class TileAtlasPage;
+
+    //! rectangle allocated in one of the atlas pages
+    /*! the rectangle is released when the region is deleted */
+    class OXYGEN_EXPORT TileAtlasRegion
+    {
+
+        public:
+
+        //! destructor
+        ~TileAtlasRegion( void );
+
+        //! page pixmap
+        QPixmap& pixmap( void ) const;
+
+        //! allocated rectangle, in page coordinates
+        const QRect& rect( void ) const
+        { return _rect; }
+
+        private:
+
+        //! constructor
+        TileAtlasRegion( TileAtlasPage*, const QRect& );
+
+        //! page
+        TileAtlasPage* _page;
+
+        //! rectangle
+        QRect _rect;
+
+        friend class TileAtlas;
+        Q_DISABLE_COPY( TileAtlasRegion )
+
+    };
+
+    //! shared handle to an atlas region
+    typedef QSharedPointer<TileAtlasRegion> TileAtlasHandle;
+
+    //! process wide storage for tileset pixmaps
+    /*!
+    pixmaps are packed in a small number of large pages, using a shelf allocator,
+    so that tilesets rendered with pixmap fragments share a few pixmaps.
+    Released regions are kept in a per-page free list and reused by later allocations.
+    Neighbouring free regions are merged, and free space at the end of shelves is given back.
+    A page is deleted once all its regions are released. The memory used by pages
+    is charged to the process wide CacheBudget, so that caches holding tilesets get
+    trimmed when pages accumulate.
+    */
+    class OXYGEN_EXPORT TileAtlas
+    {
+
+        public:
+
+        //! singleton
+        static TileAtlas& instance( void );
+
+        //! allocate a transparent region of given size
+        /*! returns a null handle if size is empty */
+        TileAtlasHandle allocate( const QSize& );
+
+        //! number of pages
+        int pageCount( void ) const
+        { return _pages.size(); }
+
+        //! default page size
+        static const int pageSize = 512;
+
+        protected:
+
+        //! release region from page
+        void release( TileAtlasPage*, const QRect& );
+
+        private:
+
+        //! constructor
+        TileAtlas( void )
+        {}
+
+        //! pages
+        QList<TileAtlasPage*> _pages;
+
+        friend class TileAtlasRegion;
+
+    };
+
+    //! atlas page
+    class TileAtlasPage
+    {
+
+        public:
+
+        //! constructor
+        explicit TileAtlasPage( const QSize& );
+
+        //! allocate rectangle of given size. Returns false if page is full
+        bool allocate( const QSize&, QRect& );
+
+        //! release one rectangle. Returns true if page is empty afterwards
+        bool release( const QRect& );
+
+        //! pixmap
+        QPixmap& pixmap( void )
+        { return _pixmap; }
+
+        //! memory used by the page pixmap, in bytes
+        qint64 cost( void ) const
+        { return qint64( _pixmap.width() )*_pixmap.height()*_pixmap.depth()/8; }
+
+        private:
+
+        //! shelf
+        class Shelf
+        {
+            public:
+
+            //! constructor
+            Shelf( int y, int height ):
+                y( y ),
+                height( height ),
+                width( 0 )
+            {}
+
+            //! vertical position
+            int y;
+
+            //! height
+            int height;
+
+            //! used width
+            int width;
+
+        };
+
+        //! pixmap
+        QPixmap _pixmap;
+
+        //! shelves
+        QList<Shelf> _shelves;
+
+        //! released rectangles, available for reuse
+        QList<QRect> _freeRects;
+
+        //! used height
+        int _height;
+
+        //! number of allocated rectangles
+        int _count;
+
+    };
+
+}
+
+#endif
@@ -58,7 +58,7 @@ namespace Oxygen
         _h1(0),
         _w3(0),
         _h3(0)
-    { _pixmaps.reserve(9); }
+    {}
 
     //______________________________________________________________
     TileSet::TileSet(const QPixmap &pix, int w1, int h1, int w2, int h2, bool stretch ):
@@ -68,7 +68,6 @@ namespace Oxygen
         _w3(0),
         _h3(0)
     {
-        _pixmaps.reserve(9);
         if (pix.isNull()) return;
 
         _w3 = pix.width() - (w1 + w2);
@@ -82,6 +81,7 @@ namespace Oxygen
         }
 
         // initialise pixmap array
+        _pixmaps.reserve(9);
         initPixmap( _pixmaps, pix, _w1, _h1, QRect(0, 0, _w1, _h1) );
         initPixmap( _pixmaps, pix, w, _h1, QRect(_w1, 0, w2, _h1) );
         initPixmap( _pixmaps, pix, _w3, _h1, QRect(_w1+w2, 0, _w3, _h1) );
@@ -91,6 +91,7 @@ namespace Oxygen
         initPixmap( _pixmaps, pix, _w1, _h3, QRect(0, _h1+h2, _w1, _h3) );
         initPixmap( _pixmaps, pix, w, _h3, QRect(_w1, _h1+h2, w2, _h3) );
         initPixmap( _pixmaps, pix, _w3, _h3, QRect(_w1+w2, _h1+h2, _w3, _h3) );
+        initAtlas();
     }
 
     //______________________________________________________________
@@ -101,7 +102,6 @@ namespace Oxygen
         _w3(w3),
         _h3(h3)
     {
-        _pixmaps.reserve(9);
         if (pix.isNull()) return;
 
         int x2 = pix.width() - _w3;
@@ -115,6 +115,7 @@ namespace Oxygen
         }
 
         // initialise pixmap array
+        _pixmaps.reserve(9);
         initPixmap( _pixmaps, pix, _w1, _h1, QRect(0, 0, _w1, _h1) );
         initPixmap( _pixmaps, pix, w, _h1, QRect(x1, 0, w2, _h1) );
         initPixmap( _pixmaps, pix, _w3, _h1, QRect(x2, 0, _w3, _h1) );
@@ -124,6 +125,7 @@ namespace Oxygen
         initPixmap( _pixmaps, pix, _w1, _h3, QRect(0, y2, _w1, _h3) );
         initPixmap( _pixmaps, pix, w, _h3, QRect(x1, y2, w2, _h3) );
         initPixmap( _pixmaps, pix, _w3, _h3, QRect(x2, y2, _w3, _h3) );
+        initAtlas();
 
     }
 
@@ -135,9 +137,6 @@ namespace Oxygen
     void TileSet::render(const QRect &r, QPainter *p, Tiles t) const
     {
 
-        const bool oldHint( p->testRenderHint( QPainter::SmoothPixmapTransform ) );
-        if( _stretch ) p->setRenderHint( QPainter::SmoothPixmapTransform, true );
-
         // check initialization
         if( _pixmaps.size() < 9 ) return;
 
@@ -172,27 +171,38 @@ namespace Oxygen
         const int y1 = y0 + hTop;
         const int y2 = y1 + h;
 
-        const int w2 = _pixmaps.at(7).width();
-        const int h2 = _pixmaps.at(5).height();
+        const int w2 = chunkSize(7).width();
+        const int h2 = chunkSize(5).height();
+
+        const bool oldHint( p->testRenderHint( QPainter::SmoothPixmapTransform ) );
+        if( _stretch ) p->setRenderHint( QPainter::SmoothPixmapTransform, true );
+
+        // corners and stretched chunks are batched in fragments when supported.
+        // Tiled chunks are always rendered with drawTiledPixmap, which handles repeats in one call
+        FragmentList fragments;
+        FragmentList* fragmentList( ( _region && hasFragmentSupport( p ) ) ? &fragments:0 );
 
         // corner
-        if( bits(t, Top|Left) )  p->drawPixmap(x0, y0, _pixmaps.at(0), 0, 0, wLeft, hTop);
-        if( bits(t, Top|Right) ) p->drawPixmap(x2, y0, _pixmaps.at(2), _w3-wRight, 0, wRight, hTop);
-        if( bits(t, Bottom|Left) )  p->drawPixmap(x0, y2, _pixmaps.at(6), 0, _h3-hBottom, wLeft,  hBottom);
-        if( bits(t, Bottom|Right) ) p->drawPixmap(x2, y2, _pixmaps.at(8), _w3-wRight, _h3-hBottom, wRight, hBottom );
+        if( bits(t, Top|Left) ) renderChunk( p, fragmentList, 0, QRect( x0, y0, wLeft, hTop ), QRect( 0, 0, wLeft, hTop ) );
+        if( bits(t, Top|Right) ) renderChunk( p, fragmentList, 2, QRect( x2, y0, wRight, hTop ), QRect( _w3-wRight, 0, wRight, hTop ) );
+        if( bits(t, Bottom|Left) ) renderChunk( p, fragmentList, 6, QRect( x0, y2, wLeft, hBottom ), QRect( 0, _h3-hBottom, wLeft, hBottom ) );
+        if( bits(t, Bottom|Right) ) renderChunk( p, fragmentList, 8, QRect( x2, y2, wRight, hBottom ), QRect( _w3-wRight, _h3-hBottom, wRight, hBottom ) );
+
+        // flush corners before tiled sides, to preserve painting order
+        if( !_stretch ) flushFragments( p, fragments );
 
         // top and bottom
         if( w > 0 )
         {
             if (t & Top )
             {
-                if( _stretch ) p->drawPixmap(x1, y0, w, hTop, _pixmaps.at(1));
+                if( _stretch ) renderChunk( p, fragmentList, 1, QRect( x1, y0, w, hTop ), QRect( QPoint(), chunkSize(1) ) );
                 else p->drawTiledPixmap(x1, y0, w, hTop, _pixmaps.at(1));
             }
 
             if (t & Bottom )
             {
-                if( _stretch ) p->drawPixmap(x1, y2, w, hBottom, _pixmaps.at(7), 0, _h3-hBottom, w2, hBottom );
+                if( _stretch ) renderChunk( p, fragmentList, 7, QRect( x1, y2, w, hBottom ), QRect( 0, _h3-hBottom, w2, hBottom ) );
                 else p->drawTiledPixmap(x1, y2, w, hBottom, _pixmaps.at(7), 0, _h3-hBottom );
             }
 
@@ -203,13 +213,13 @@ namespace Oxygen
         {
             if (t & Left )
             {
-                if( _stretch ) p->drawPixmap(x0, y1, wLeft, h, _pixmaps.at(3));
+                if( _stretch ) renderChunk( p, fragmentList, 3, QRect( x0, y1, wLeft, h ), QRect( QPoint(), chunkSize(3) ) );
                 else p->drawTiledPixmap(x0, y1, wLeft, h, _pixmaps.at(3));
             }
 
             if (t & Right )
             {
-                if( _stretch ) p->drawPixmap(x2, y1, wRight, h, _pixmaps.at(5), _w3-wRight, 0, wRight, h2 );
+                if( _stretch ) renderChunk( p, fragmentList, 5, QRect( x2, y1, wRight, h ), QRect( _w3-wRight, 0, wRight, h2 ) );
                 else p->drawTiledPixmap(x2, y1, wRight, h, _pixmaps.at(5), _w3-wRight, 0 );
             }
         }
@@ -217,14 +227,155 @@ namespace Oxygen
         // center
         if ( (t & Center) && h > 0 && w > 0 )
         {
-            if( _stretch ) p->drawPixmap(x1, y1, w, h, _pixmaps.at(4));
+            if( _stretch ) renderChunk( p, fragmentList, 4, QRect( x1, y1, w, h ), QRect( QPoint(), chunkSize(4) ) );
             else p->drawTiledPixmap(x1, y1, w, h, _pixmaps.at(4));
         }
 
+        flushFragments( p, fragments );
+
         if( _stretch ) p->setRenderHint( QPainter::SmoothPixmapTransform, oldHint );
 
     }
 
+    //___________________________________________________________
+    void TileSet::flushFragments( QPainter* painter, FragmentList& fragments ) const
+    {
+        if( fragments.isEmpty() ) return;
+        painter->drawPixmapFragments( fragments.constData(), fragments.size(), _region->pixmap() );
+        fragments.clear();
+    }
+
+    //___________________________________________________________
+    bool TileSet::hasFragmentSupport( QPainter* painter )
+    {
+        // only the OpenGL2 engine batches fragments. Other engines, including raster,
+        // emulate them with one drawPixmap call per fragment, and painter state changes in between
+        const QPaintEngine* engine( painter->paintEngine() );
+        return engine && engine->type() == QPaintEngine::OpenGL2;
+    }
+
+    //___________________________________________________________
+    void TileSet::initAtlas( void )
+    {
+
+        _rects.fill( QRect(), 9 );
+
+        // corners are stored in the atlas, as well as sides and center when stretched.
+        // Tiled chunks keep their own pixmap, as needed by drawTiledPixmap
+        bool stored[9];
+        for( int i = 0; i < 9; ++i )
+        { stored[i] = ( _stretch || i == 0 || i == 2 || i == 6 || i == 8 ) && !_pixmaps[i].isNull(); }
+
+        // column widths and row heights
+        int widths[3] = { 0, 0, 0 };
+        int heights[3] = { 0, 0, 0 };
+        for( int i = 0; i < 9; ++i )
+        {
+            if( !stored[i] ) continue;
+            widths[i%3] = qMax( widths[i%3], _pixmaps[i].width() );
+            heights[i/3] = qMax( heights[i/3], _pixmaps[i].height() );
+        }
+
+        // each chunk is surrounded by a one pixel border, to prevent bleeding when scaled
+        _region = TileAtlas::instance().allocate( QSize(
+            widths[0] + widths[1] + widths[2] + 6,
+            heights[0] + heights[1] + heights[2] + 6 ) );
+        if( !_region ) return;
+
+        // clear region, since it might have been used by another tileset
+        QPainter painter( &_region->pixmap() );
+        painter.setCompositionMode( QPainter::CompositionMode_Source );
+        painter.fillRect( _region->rect(), Qt::transparent );
+
+        int y( _region->rect().top() + 1 );
+        for( int row = 0; row < 3; ++row )
+        {
+
+            int x( _region->rect().left() + 1 );
+            for( int column = 0; column < 3; ++column )
+            {
+
+                const int index( 3*row + column );
+                if( stored[index] )
+                {
+
+                    const QPixmap pixmap( _pixmaps[index] );
+                    const QRect rect( QPoint( x, y ), pixmap.size() );
+                    painter.drawPixmap( rect.topLeft(), pixmap );
+
+                    // replicate edges in border, for stretched tilesets
+                    if( _stretch )
+                    {
+                        const int w( pixmap.width() );
+                        const int h( pixmap.height() );
+                        painter.drawPixmap( QRect( rect.left(), rect.top()-1, w, 1 ), pixmap, QRect( 0, 0, w, 1 ) );
+                        painter.drawPixmap( QRect( rect.left(), rect.bottom()+1, w, 1 ), pixmap, QRect( 0, h-1, w, 1 ) );
+                        painter.drawPixmap( QRect( rect.left()-1, rect.top(), 1, h ), pixmap, QRect( 0, 0, 1, h ) );
+                        painter.drawPixmap( QRect( rect.right()+1, rect.top(), 1, h ), pixmap, QRect( w-1, 0, 1, h ) );
+                        painter.drawPixmap( QRect( rect.left()-1, rect.top()-1, 1, 1 ), pixmap, QRect( 0, 0, 1, 1 ) );
+                        painter.drawPixmap( QRect( rect.right()+1, rect.top()-1, 1, 1 ), pixmap, QRect( w-1, 0, 1, 1 ) );
+                        painter.drawPixmap( QRect( rect.left()-1, rect.bottom()+1, 1, 1 ), pixmap, QRect( 0, h-1, 1, 1 ) );
+                        painter.drawPixmap( QRect( rect.right()+1, rect.bottom()+1, 1, 1 ), pixmap, QRect( w-1, h-1, 1, 1 ) );
+                    }
+
+                    // release own pixmap
+                    _rects[index] = rect;
+                    _pixmaps[index] = QPixmap();
+
+                }
+
+                x += widths[column] + 2;
+
+            }
+
+            y += heights[row] + 2;
+
+        }
+
+    }
+
+    //___________________________________________________________
+    void TileSet::renderChunk( QPainter* painter, FragmentList* fragments, int index, const QRect& target, const QRect& source ) const
+    {
+
+        if( target.isEmpty() || source.isEmpty() ) return;
+        if( !_rects[index].isValid() )
+        {
+            painter->drawPixmap( target, _pixmaps.at( index ), source );
+            return;
+        }
+
+        // render from atlas, scaled if needed
+        const QRect atlasSource( source.translated( _rects[index].topLeft() ) );
+        if( fragments )
+        {
+
+            fragments->append( QPainter::PixmapFragment::create(
+                QRectF( target ).center(),
+                QRectF( atlasSource ),
+                qreal( target.width() )/source.width(),
+                qreal( target.height() )/source.height() ) );
+
+        } else painter->drawPixmap( target, _region->pixmap(), atlasSource );
+
+    }
+
+    //___________________________________________________________
+    QPixmap TileSet::pixmap( int index ) const
+    {
+        if( _rects[index].isValid() ) return _region->pixmap().copy( _rects[index] );
+        else return _pixmaps[index];
+    }
+
+    //___________________________________________________________
+    qint64 TileSet::cost( void ) const
+    {
+        qint64 out( 0 );
+        foreach( const QPixmap& pixmap, _pixmaps )
+        { out += qint64( pixmap.width() )*pixmap.height()*pixmap.depth()/8; }
+        return out;
+    }
+
     //___________________________________________________________
     void TileSet::save( const QString& basename, const QString& suffix, const char* format, int quality ) const
     {
@@ -236,10 +387,11 @@ namespace Oxygen
         {
 
             // check pixmap validity
-            if( _pixmaps[i].isNull() ) continue;
+            const QPixmap pixmap( this->pixmap( i ) );
+            if( pixmap.isNull() ) continue;
 
             const QString filename = basename + "-" + location[i] + "." + suffix;
-            _pixmaps[i].save( filename, format, quality );
+            pixmap.save( filename, format, quality );
         }
 
     }
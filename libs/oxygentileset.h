@@ -22,7 +22,9 @@
  */
 
 #include "oxygen_export.h"
+#include "oxygentileatlas.h"
 
+#include <QtGui/QPainter>
 #include <QtGui/QPixmap>
 #include <QtCore/QRect>
 #include <QtCore/QVector>
@@ -102,6 +104,10 @@ namespace Oxygen
         edges are tiled in one direction, and the center chunk is tiled in both
         directions. Partial tiles are used as needed so that the entire rect is
         perfectly filled. Filling is performed as if all chunks are being drawn.
+
+        Corners and stretched chunks are stored in a shared atlas page, and drawn from there.
+        With the OpenGL2 paint engine, they are rendered with QPainter::drawPixmapFragments.
+        Tiled chunks keep their own pixmap, and are drawn with drawTiledPixmap.
         */
         void render(const QRect&, QPainter*, Tiles = Ring) const;
 
@@ -113,6 +119,10 @@ namespace Oxygen
         bool isValid( void ) const
         { return _pixmaps.size() == 9; }
 
+        //! memory used by chunks stored in their own pixmap, in bytes
+        /*! atlas pages are charged to the cache budget separately */
+        qint64 cost( void ) const;
+
         //! save all pixmaps
         /*! pixmap names will be \p basename-position.suffix. Other arguments are the same as for QPixmap::save */
         void save( const QString& basename, const QString& suffix = "png", const char* format = 0, int quality = -1 ) const;
@@ -126,8 +136,8 @@ namespace Oxygen
         { _sideExtent = value; }
 
         //! returns pixmap for given index
-        QPixmap pixmap( int index ) const
-        { return _pixmaps[index]; }
+        /*! chunks stored in the atlas are copied */
+        QPixmap pixmap( int index ) const;
 
         protected:
 
@@ -137,6 +147,27 @@ namespace Oxygen
         //! initialize pixmap
         void initPixmap( PixmapList&, const QPixmap&, int w, int h, const QRect& );
 
+        //! shortcut to fragment list
+        typedef QVector<QPainter::PixmapFragment> FragmentList;
+
+        //! true if painter's engine renders pixmap fragments in one pass
+        static bool hasFragmentSupport( QPainter* );
+
+        //! move corners and stretched chunks to the atlas, laid out on a 3x3 grid
+        /*! their own pixmap is released. Tiled chunks are kept, as needed by drawTiledPixmap */
+        void initAtlas( void );
+
+        //! size of given chunk
+        QSize chunkSize( int index ) const
+        { return _rects[index].isValid() ? _rects[index].size():_pixmaps[index].size(); }
+
+        //! render pending fragments from the atlas, and clear the list
+        void flushFragments( QPainter*, FragmentList& ) const;
+
+        //! render given chunk region in target rect, stretched if sizes differ
+        /*! a fragment is added to the list instead, if any */
+        void renderChunk( QPainter*, FragmentList*, int index, const QRect& target, const QRect& source ) const;
+
         private:
 
         //! side extend
@@ -146,9 +177,15 @@ namespace Oxygen
         */
         static int _sideExtent;
 
-        //! pixmap arry
+        //! pixmap array. Chunks stored in the atlas have a null pixmap
         PixmapList _pixmaps;
 
+        //! atlas region holding corners and stretched chunks
+        TileAtlasHandle _region;
+
+        //! chunks location in atlas page. Invalid for chunks stored in their own pixmap
+        QVector<QRect> _rects;
+
         // stretch pixmaps
         bool _stretch;
 
@@ -35,6 +35,8 @@
 #include <cmath>
 
 #include "oxygenanimation.h"
+#include "oxygenanimationclock.h"
+#include "oxygenrepaintstatistics.h"
 
 namespace Oxygen
 {
@@ -94,7 +96,19 @@ namespace Oxygen
 
         //! trigger target update
         virtual void setDirty( void ) const
-        { if( _target ) _target.data()->update(); }
+        { setDirty( QRect() ); }
+
+        //! trigger target update, restricted to given rect
+        /*!
+        it is used when only one subcontrol is animated. An invalid rect updates the full target.
+        Updates triggered by the animation clock are merged, and sent once per tick
+        */
+        void setDirty( const QRect& rect ) const
+        {
+            if( !_target ) return;
+            RepaintStatistics::add( parent(), _target.data(), rect );
+            AnimationClock::instance().update( _target.data(), rect );
+        }
 
         private:
 
@@ -28,7 +28,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include <QtCore/QObject>
-#include <QtCore/QMap>
+#include <QtCore/QHash>
 #include <QtCore/QWeakPointer>
 
 #include <QtGui/QPaintDevice>
@@ -37,8 +37,12 @@ namespace Oxygen
 {
 
     //! data map
-    /*! it maps templatized data object to associated object */
-    template< typename K, typename T > class BaseDataMap: public QMap< const K*, QWeakPointer<T> >
+    /*!
+    it maps templatized data object to associated object.
+    A hash is used rather than a map for constant time lookup, and the last few
+    lookups are cached, since a given frame usually paints the same widgets several times
+    */
+    template< typename K, typename T > class BaseDataMap: public QHash< const K*, QWeakPointer<T> >
     {
 
         public:
@@ -48,35 +52,45 @@ namespace Oxygen
 
         //! constructor
         BaseDataMap( void ):
-            QMap<Key, Value>(),
+            QHash<Key, Value>(),
             _enabled( true ),
-            _lastKey( NULL )
-        {}
+            _lastIndex( 0 )
+        { clearRecent(); }
 
         //! destructor
         virtual ~BaseDataMap( void )
         {}
 
         //! insertion
-        virtual typename QMap< Key, Value >::iterator insert( const Key& key, const Value& value, bool enabled = true )
+        virtual typename QHash< Key, Value >::iterator insert( const Key& key, const Value& value, bool enabled = true )
         {
             if( value ) value.data()->setEnabled( enabled );
-            return QMap< Key, Value >::insert( key, value );
+
+            // clear recent value if needed
+            removeRecent( key );
+            return QHash< Key, Value >::insert( key, value );
         }
 
         //! find value
         Value find( Key key )
         {
             if( !( enabled() && key ) ) return Value();
-            if( key == _lastKey ) return _lastValue;
-            else {
-                Value out;
-                typename QMap<Key, Value>::iterator iter( QMap<Key, Value>::find( key ) );
-                if( iter != QMap<Key, Value>::end() ) out = iter.value();
-                _lastKey = key;
-                _lastValue = out;
-                return out;
-            }
+
+            // check recent lookups
+            for( int i = 0; i < RecentSize; ++i )
+            { if( _recentKeys[i] == key ) return _recentValues[i]; }
+
+            // find in hash
+            Value out;
+            typename QHash<Key, Value>::iterator iter( QHash<Key, Value>::find( key ) );
+            if( iter != QHash<Key, Value>::end() ) out = iter.value();
+
+            // store as most recent, replacing the oldest entry
+            _lastIndex = ( _lastIndex + 1 ) % RecentSize;
+            _recentKeys[_lastIndex] = key;
+            _recentValues[_lastIndex] = out;
+            return out;
+
         }
 
         //! unregister widget
@@ -86,22 +100,16 @@ namespace Oxygen
             // check key
             if( !key ) return false;
 
-            // clear last value if needed
-            if( key == _lastKey )
-            {
-
-                if( _lastValue ) _lastValue.clear();
-                _lastKey = NULL;
-
-            }
+            // clear recent value if needed
+            removeRecent( key );
 
             // find key in map
-            typename QMap<Key, Value>::iterator iter( QMap<Key, Value>::find( key ) );
-            if( iter == QMap<Key, Value>::end() ) return false;
+            typename QHash<Key, Value>::iterator iter( QHash<Key, Value>::find( key ) );
+            if( iter == QHash<Key, Value>::end() ) return false;
 
             // delete value from map if found
             if( iter.value() ) iter.value().data()->deleteLater();
-            QMap<Key, Value>::erase( iter );
+            QHash<Key, Value>::erase( iter );
 
             return true;
 
@@ -126,16 +134,45 @@ namespace Oxygen
             { if( value ) value.data()->setDuration( duration ); }
         }
 
+        protected:
+
+        //! remove key from recent lookups
+        void removeRecent( Key key )
+        {
+            for( int i = 0; i < RecentSize; ++i )
+            {
+                if( _recentKeys[i] != key ) continue;
+                _recentKeys[i] = NULL;
+                _recentValues[i].clear();
+            }
+        }
+
+        //! clear recent lookups
+        void clearRecent( void )
+        {
+            for( int i = 0; i < RecentSize; ++i )
+            {
+                _recentKeys[i] = NULL;
+                _recentValues[i].clear();
+            }
+        }
+
         private:
 
+        //! number of recent lookups
+        enum { RecentSize = 4 };
+
         //! enability
         bool _enabled;
 
-        //! last key
-        Key _lastKey;
+        //! index of most recent lookup
+        int _lastIndex;
+
+        //! recent keys
+        Key _recentKeys[RecentSize];
 
-        //! last value
-        Value _lastValue;
+        //! recent values
+        Value _recentValues[RecentSize];
 
     };
 
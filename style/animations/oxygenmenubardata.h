@@ -147,7 +147,7 @@ namespace Oxygen
             value = digitize( value );
             if( _current._opacity == value ) return;
             _current._opacity = value;
-            setDirty();
+            setDirty( _current._rect );
         }
 
         //! current rect
@@ -164,7 +164,7 @@ namespace Oxygen
             value = digitize( value );
             if( _previous._opacity == value ) return;
             _previous._opacity = value;
-            setDirty();
+            setDirty( _previous._rect );
         }
 
         //! previous rect
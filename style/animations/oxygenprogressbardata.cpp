@@ -113,7 +113,7 @@ namespace Oxygen
             animation().data()->stop();
             setOpacity(0);
 
-            if( target() ) target().data()->update();
+            setDirty();
 
             return;
 
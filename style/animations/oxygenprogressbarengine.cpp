@@ -27,6 +27,8 @@
 #include "oxygenprogressbarengine.h"
 #include "oxygenprogressbarengine.moc"
 
+#include "oxygenrepaintstatistics.h"
+
 namespace Oxygen
 {
 
@@ -100,11 +102,16 @@ namespace Oxygen
             if( progressBar && progressBar->isVisible() && progressBar->minimum() == 0 && progressBar->maximum() == 0  )
             {
 
+                // pause progressbars that are clipped by their parents, e.g. scrolled out of view.
+                // The timer is restarted when they get painted again
+                if( progressBar->visibleRegion().isEmpty() ) continue;
+
                 // update animation flag
                 animated = true;
 
                 // update value
                 progressBar->setProperty( busyValuePropertyName, progressBar->property( busyValuePropertyName ).toInt()+1 );
+                RepaintStatistics::add( this, progressBar );
                 progressBar->update();
 
             } else if( *iter ) { (*iter)->setProperty( busyValuePropertyName, 0 ); }
@@ -118,7 +118,7 @@ namespace Oxygen
             value = digitize( value );
             if( _addLineData._opacity == value ) return;
             _addLineData._opacity = value;
-            setDirty();
+            setDirty( _addLineData._rect );
         }
 
         //! addLine opacity
@@ -131,7 +131,7 @@ namespace Oxygen
             value = digitize( value );
             if( _subLineData._opacity == value ) return;
             _subLineData._opacity = value;
-            setDirty();
+            setDirty( _subLineData._rect );
         }
 
         //! subLine opacity
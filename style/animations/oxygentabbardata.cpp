@@ -28,6 +28,7 @@
 
 #include "oxygentabbardata.h"
 #include "oxygentabbardata.moc"
+#include "oxygenmetrics.h"
 
 #include <QtGui/QHoverEvent>
 #include <QtGui/QTabBar>
@@ -127,5 +128,15 @@ namespace Oxygen
 
     }
 
+    //______________________________________________
+    QRect TabBarData::tabRect( int index ) const
+    {
+        const QTabBar* local( qobject_cast<const QTabBar*>( target().data() ) );
+        if( !( local && index >= 0 ) ) return QRect();
+
+        // tab slabs extend past the tab rect, on all sides, by the slab shadow and glow
+        const int margin( 7 + GlowWidth );
+        return local->tabRect( index ).adjusted( -margin, -margin, margin, margin );
+    }
 
 }
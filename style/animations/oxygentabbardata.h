@@ -75,7 +75,7 @@ namespace Oxygen
         {
             if( _current._opacity == value ) return;
             _current._opacity = value;
-            setDirty();
+            setDirty( tabRect( _current._index ) );
         }
 
         //! current index
@@ -104,7 +104,7 @@ namespace Oxygen
         {
             if( _previous._opacity == value ) return;
             _previous._opacity = value;
-            setDirty();
+            setDirty( tabRect( _previous._index ) );
         }
 
         //! previous index
@@ -127,6 +127,12 @@ namespace Oxygen
         //! return opacity associated to action at given position, if any
         virtual qreal opacity( const QPoint& position ) const;
 
+        protected:
+
+        //! rect painted by tab matching given index, or invalid rect if none
+        /*! it includes the tab slab margins, which extend past QTabBar::tabRect */
+        QRect tabRect( int index ) const;
+
         private:
 
         //! container for needed animation data
@@ -56,6 +56,10 @@ namespace Oxygen
         */
         virtual bool updateState( bool value );
 
+        //! state
+        bool state( void ) const
+        { return _state; }
+
         private:
 
         bool _state;
@@ -33,14 +33,24 @@
 namespace Oxygen
 {
 
+    //____________________________________________________________
+    const int WidgetStateEngine::_reclaimDelay = 10000;
+
     //____________________________________________________________
     bool WidgetStateEngine::registerWidget( QWidget* widget, AnimationModes mode )
     {
 
         if( !widget ) return false;
-        if( mode&AnimationHover && !_hoverData.contains( widget ) ) { _hoverData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); }
-        if( mode&AnimationFocus && !_focusData.contains( widget ) ) { _focusData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); }
-        if( mode&AnimationEnable && !_enableData.contains( widget ) ) { _enableData.insert( widget, new EnableData( this, widget, duration() ), enabled() ); }
+
+        // store modes. Data are created on first state change
+        _modes[widget] |= mode;
+
+        // enability changes are caught from the widget events
+        if( mode&AnimationEnable )
+        {
+            widget->removeEventFilter( this );
+            widget->installEventFilter( this );
+        }
 
         // connect destruction signal
         connect( widget, SIGNAL(destroyed(QObject*)), this, SLOT(unregisterWidget(QObject*)), Qt::UniqueConnection );
@@ -50,30 +60,40 @@ namespace Oxygen
     }
 
     //____________________________________________________________
-    BaseEngine::WidgetList WidgetStateEngine::registeredWidgets( AnimationModes mode ) const
+    bool WidgetStateEngine::eventFilter( QObject* object, QEvent* event )
     {
 
-        WidgetList out;
+        if( event->type() == QEvent::EnabledChange )
+        {
 
-        // the typedef is needed to make Krazy happy
-        typedef DataMap<WidgetStateData>::Value Value;
+            const bool enabled( static_cast<QWidget*>( object )->isEnabled() );
+            if( !_enableData.contains( object ) )
+            {
 
-        if( mode&AnimationHover )
-        {
-            foreach( const Value& value, _hoverData )
-            { if( value ) out.insert( value.data()->target().data() ); }
-        }
+                // create data, which handles further changes, and update state
+                DataMap<WidgetStateData>::Value data( createData( object, AnimationEnable ) );
+                if( data ) data.data()->updateState( enabled );
+
+            }
+
+            // data are back to default state, and can be deleted once the animation is over
+            if( enabled && _enableData.contains( object ) ) startReclaimTimer();
 
-        if( mode&AnimationFocus )
-        {
-            foreach( const Value& value, _focusData )
-            { if( value ) out.insert( value.data()->target().data() ); }
         }
 
-        if( mode&AnimationEnable )
+        return BaseEngine::eventFilter( object, event );
+
+    }
+
+    //____________________________________________________________
+    BaseEngine::WidgetList WidgetStateEngine::registeredWidgets( AnimationModes mode ) const
+    {
+
+        WidgetList out;
+        for( ModeHash::const_iterator iter = _modes.constBegin(); iter != _modes.constEnd(); ++iter )
         {
-            foreach( const Value& value, _enableData )
-            { if( value ) out.insert( value.data()->target().data() ); }
+            if( iter.value() & mode )
+            { out.insert( static_cast<QWidget*>( const_cast<QObject*>( iter.key() ) ) ); }
         }
 
         return out;
@@ -84,7 +104,17 @@ namespace Oxygen
     bool WidgetStateEngine::updateState( const QObject* object, AnimationMode mode, bool value )
     {
         DataMap<WidgetStateData>::Value data( WidgetStateEngine::data( object, mode ) );
-        return ( data && data.data()->updateState( value ) );
+
+        // create data on first change from default state
+        const bool defaultState( mode == AnimationEnable );
+        if( !( data || value == defaultState ) )
+        { data = createData( object, mode ); }
+
+        if( !( data && data.data()->updateState( value ) ) ) return false;
+
+        // data are back to default state, and can be deleted once the animation is over
+        if( value == defaultState ) startReclaimTimer();
+        return true;
     }
 
     //____________________________________________________________
@@ -96,6 +126,67 @@ namespace Oxygen
 
     }
 
+    //____________________________________________________________
+    DataMap<WidgetStateData>::Value WidgetStateEngine::createData( const QObject* object, AnimationMode mode )
+    {
+
+        // check enability and registration
+        if( !( enabled() && object && ( _modes.value( object ) & mode ) ) ) return DataMap<WidgetStateData>::Value();
+
+        QWidget* widget( static_cast<QWidget*>( const_cast<QObject*>( object ) ) );
+        DataMap<WidgetStateData>::Value data;
+        switch( mode )
+        {
+            case AnimationHover: data = *_hoverData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); break;
+            case AnimationFocus: data = *_focusData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); break;
+            case AnimationEnable: data = *_enableData.insert( widget, new EnableData( this, widget, duration() ), enabled() ); break;
+            default: break;
+        }
+
+        return data;
+
+    }
+
+    //____________________________________________________________
+    void WidgetStateEngine::timerEvent( QTimerEvent* event )
+    {
+
+        if( event->timerId() != _timer.timerId() ) return BaseEngine::timerEvent( event );
+
+        // data that are not in default state are not reclaimable until their state changes back,
+        // which restarts the timer
+        bool pending( false );
+        if( reclaim( _hoverData, false ) ) pending = true;
+        if( reclaim( _focusData, false ) ) pending = true;
+        if( reclaim( _enableData, true ) ) pending = true;
+
+        if( !pending ) _timer.stop();
+
+    }
+
+    //____________________________________________________________
+    bool WidgetStateEngine::reclaim( DataMap<WidgetStateData>& dataMap, bool defaultState )
+    {
+
+        // collect idle data, in default state
+        bool pending( false );
+        QList<const QObject*> keys;
+        for( DataMap<WidgetStateData>::const_iterator iter = dataMap.constBegin(); iter != dataMap.constEnd(); ++iter )
+        {
+            const DataMap<WidgetStateData>::Value& value( iter.value() );
+            if( !value ) keys.append( iter.key() );
+            else if( value.data()->state() != defaultState ) continue;
+            else if( value.data()->animation().data()->isRunning() ) pending = true;
+            else keys.append( iter.key() );
+        }
+
+        foreach( const QObject* key, keys )
+        { dataMap.unregisterWidget( key ); }
+
+        return pending;
+
+    }
+
     //____________________________________________________________
     DataMap<WidgetStateData>::Value WidgetStateEngine::data( const QObject* object, AnimationMode mode )
     {
@@ -32,10 +32,18 @@
 #include "oxygenwidgetstatedata.h"
 #include "oxygenanimationmodes.h"
 
+#include <QtCore/QBasicTimer>
+#include <QtCore/QHash>
+#include <QtCore/QTimerEvent>
+
 namespace Oxygen
 {
 
     //! used for simple widgets
+    /*!
+    animation data are only created on the first state change of a registered widget,
+    and deleted again once the widget has been idle long enough
+    */
     class WidgetStateEngine: public BaseEngine
     {
 
@@ -55,6 +63,13 @@ namespace Oxygen
         //! register widget
         virtual bool registerWidget( QWidget*, AnimationModes );
 
+        //! event filter
+        /*!
+        it is used to create enability data on first enability change,
+        and to schedule their deletion when widgets get enabled again
+        */
+        virtual bool eventFilter( QObject*, QEvent* );
+
         //! returns registered widgets
         virtual WidgetList registeredWidgets( AnimationModes ) const;
 
@@ -94,7 +109,7 @@ namespace Oxygen
         virtual bool unregisterWidget( QObject* object )
         {
             if( !object ) return false;
-            bool found = false;
+            bool found = _modes.remove( object );
             if( _hoverData.unregisterWidget( object ) ) found = true;
             if( _focusData.unregisterWidget( object ) ) found = true;
             if( _enableData.unregisterWidget( object ) ) found = true;
@@ -106,8 +121,34 @@ namespace Oxygen
         //! returns data associated to widget
         DataMap<WidgetStateData>::Value data( const QObject*, AnimationMode );
 
+        //! create data associated to widget, if registered
+        DataMap<WidgetStateData>::Value createData( const QObject*, AnimationMode );
+
+        //! start reclaim timer, unless already running
+        /*! it is called whenever data are back to default state */
+        void startReclaimTimer( void )
+        { if( !_timer.isActive() ) _timer.start( _reclaimDelay, this ); }
+
+        //! timer event
+        /*! it is used to delete idle data */
+        virtual void timerEvent( QTimerEvent* );
+
+        //! delete data that are idle and in default state, from a given map
+        /*! returns true if some data are in default state but still animated, and must be reclaimed later */
+        bool reclaim( DataMap<WidgetStateData>&, bool defaultState );
+
         private:
 
+        //! animation modes of registered widgets
+        typedef QHash<const QObject*, AnimationModes> ModeHash;
+        ModeHash _modes;
+
+        //! timer used to delete idle data
+        QBasicTimer _timer;
+
+        //! delay after which idle data are deleted (milliseconds)
+        static const int _reclaimDelay;
+
         //! maps
         DataMap<WidgetStateData> _hoverData;
         DataMap<WidgetStateData> _focusData;
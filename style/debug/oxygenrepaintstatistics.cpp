@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////////////
+// oxygenrepaintstatistics.cpp
+// accounts widget updates triggered by animations
+// -------------------
+//
+// Copyright (c) 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////
+
+#include "oxygenrepaintstatistics.h"
+
+#include <QtCore/QCoreApplication>
+
+#include <cstdio>
+
+namespace Oxygen
+{
+
+    //_______________________________________________________________
+    RepaintStatistics* RepaintStatistics::_instance = 0;
+    bool RepaintStatistics::_initialized = false;
+
+    //_______________________________________________________________
+    RepaintStatistics* RepaintStatistics::instance( void )
+    {
+        if( !_initialized )
+        {
+            _initialized = true;
+            if( !qgetenv( "OXYGEN_REPAINT_STATISTICS" ).isEmpty() )
+            {
+                _instance = new RepaintStatistics();
+                qAddPostRoutine( printStatistics );
+            }
+        }
+
+        return _instance;
+    }
+
+    //_______________________________________________________________
+    void RepaintStatistics::add( const QObject* source, const QWidget* widget, const QRect& rect )
+    {
+
+        RepaintStatistics* statistics( instance() );
+        if( !( statistics && widget ) ) return;
+
+        Record& record( statistics->_records[source ? source->metaObject()->className():"unknown"] );
+        const QRect local( rect.isValid() ? rect:widget->rect() );
+        ++record.updates;
+        record.area += local.width()*local.height();
+
+    }
+
+    //_______________________________________________________________
+    void RepaintStatistics::print( QTextStream& stream ) const
+    {
+
+        stream << "# Oxygen::RepaintStatistics - application: " << QCoreApplication::applicationName() << endl;
+        stream << "# source\tupdates\tpixels\tpixels/update" << endl;
+        for( RecordMap::const_iterator iter = _records.constBegin(); iter != _records.constEnd(); ++iter )
+        {
+            const Record& record( iter.value() );
+            stream
+                << iter.key() << "\t"
+                << record.updates << "\t"
+                << record.area << "\t"
+                << record.area/record.updates
+                << endl;
+        }
+
+    }
+
+    //_______________________________________________________________
+    void RepaintStatistics::printStatistics( void )
+    {
+        if( !_instance ) return;
+
+        QTextStream stream( stderr );
+        _instance->print( stream );
+
+        delete _instance;
+        _instance = 0;
+    }
+
+}
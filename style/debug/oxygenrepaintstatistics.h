@@ -0,0 +1,101 @@
+#ifndef oxygenrepaintstatistics_h
+#define oxygenrepaintstatistics_h
+
+//////////////////////////////////////////////////////////////////////////////
+// oxygenrepaintstatistics.h
+// accounts widget updates triggered by animations
+// -------------------
+//
+// Copyright (c) 2013 Hugo Pereira Da Costa <hugo.pereira@free.fr>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QRect>
+#include <QtCore/QTextStream>
+#include <QtGui/QWidget>
+
+namespace Oxygen
+{
+
+    //! accounts widget updates triggered by animations
+    /*!
+    Setting OXYGEN_REPAINT_STATISTICS in the environment prints, on exit, the number
+    of updates and the repainted area requested by each animation engine.
+    Nothing is recorded otherwise.
+    */
+    class RepaintStatistics
+    {
+
+        public:
+
+        //! record update of given widget rect, requested by given source
+        /*! an invalid rect stands for the full widget */
+        static void add( const QObject* source, const QWidget*, const QRect& = QRect() );
+
+        private:
+
+        //! constructor
+        explicit RepaintStatistics( void )
+        {}
+
+        //! instance, or null if statistics are disabled
+        static RepaintStatistics* instance( void );
+
+        //! print statistics to stream
+        void print( QTextStream& ) const;
+
+        //! print statistics to stderr and delete instance
+        static void printStatistics( void );
+
+        //! requested updates and area for a given source
+        class Record
+        {
+            public:
+
+            //! constructor
+            Record( void ):
+                updates( 0 ),
+                area( 0 )
+            {}
+
+            qint64 updates;
+            qint64 area;
+
+        };
+
+        //! map source class name to records
+        /*! a map is used so that output is sorted */
+        typedef QMap<QByteArray, Record> RecordMap;
+        RecordMap _records;
+
+        //! instance
+        static RepaintStatistics* _instance;
+
+        //! true once environment has been checked
+        static bool _initialized;
+
+    };
+
+}
+
+#endif
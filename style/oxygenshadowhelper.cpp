@@ -64,11 +64,8 @@ namespace Oxygen
     ShadowHelper::~ShadowHelper( void )
     {
 
-        #ifdef Q_WS_X11
-        foreach( const Qt::HANDLE& value, _pixmaps  ) XFreePixmap( QX11Info::display(), value );
-        foreach( const Qt::HANDLE& value, _dockPixmaps  ) XFreePixmap( QX11Info::display(), value );
-        #endif
-
+        freePixmaps( _pixmaps );
+        freePixmaps( _dockPixmaps );
         delete _shadowCache;
 
     }
@@ -76,17 +73,16 @@ namespace Oxygen
     //______________________________________________
     void ShadowHelper::reset( void )
     {
-        #ifdef Q_WS_X11
-        // round pixmaps
-        foreach( const Qt::HANDLE& value, _pixmaps  ) XFreePixmap( QX11Info::display(), value );
-        foreach( const Qt::HANDLE& value, _dockPixmaps  ) XFreePixmap( QX11Info::display(), value );
-        #endif
+        freePixmaps( _pixmaps );
+        freePixmaps( _dockPixmaps );
 
         _pixmaps.clear();
         _dockPixmaps.clear();
 
         _tiles = TileSet();
         _dockTiles = TileSet();
+        _shadowImage = QImage();
+        _dockShadowImage = QImage();
 
         // reset size
         _size = 0;
@@ -136,11 +132,8 @@ namespace Oxygen
         // shadow cache
         shadowCache().readConfig();
 
-        // reset
-        reset();
-
         // retrieve shadow pixmap
-        _size = shadowCache().shadowSize();
+        const int size( shadowCache().shadowSize() );
 
         QPixmap pixmap( shadowCache().pixmap( ShadowCache::Key() ) );
         if( !pixmap.isNull() )
@@ -152,25 +145,45 @@ namespace Oxygen
             painter.fillRect( pixmap.rect(), QColor( 0, 0, 0, 150 ) );
         }
 
-        // recreate tileset
-        _tiles = TileSet( pixmap, pixmap.width()/2, pixmap.height()/2, 1, 1 );
-
-        if( !pixmap.isNull() )
+        QPixmap dockPixmap( pixmap.copy() );
+        if( !dockPixmap.isNull() )
         {
-            QPainter painter( &pixmap );
+            QPainter painter( &dockPixmap );
 
             // add round corners
-            const QRect cornerRect( (pixmap.width()-10)/2, (pixmap.height()-10)/2, 10, 10 );
+            const QRect cornerRect( (dockPixmap.width()-10)/2, (dockPixmap.height()-10)/2, 10, 10 );
             _helper.roundCorner( QPalette().color( QPalette::Window ) )->render( cornerRect, &painter );
         }
 
-        // recreate tileset
-        _dockTiles = TileSet( pixmap, pixmap.width()/2, pixmap.height()/2, 1, 1 );
+        /*
+        pixmap handles are shared by all registered widgets. They are kept, together with the
+        installed properties, when the shadow configuration is unchanged
+        */
+        const QImage image( pixmap.toImage() );
+        const QImage dockImage( dockPixmap.toImage() );
+        if( size == _size && image == _shadowImage && dockImage == _dockShadowImage ) return;
+
+        // keep previous handles until the properties that refer to them are updated
+        const QVector<Qt::HANDLE> pixmaps( _pixmaps );
+        const QVector<Qt::HANDLE> dockPixmaps( _dockPixmaps );
+        _pixmaps.clear();
+        _dockPixmaps.clear();
+
+        // recreate tilesets
+        _size = size;
+        _shadowImage = image;
+        _dockShadowImage = dockImage;
+        _tiles = TileSet( pixmap, pixmap.width()/2, pixmap.height()/2, 1, 1 );
+        _dockTiles = TileSet( dockPixmap, dockPixmap.width()/2, dockPixmap.height()/2, 1, 1 );
 
         // update property for registered widgets
         for( QMap<QWidget*,WId>::const_iterator iter = _widgets.constBegin(); iter != _widgets.constEnd(); ++iter )
         { installX11Shadows( iter.key() ); }
 
+        // release previous handles
+        freePixmaps( pixmaps );
+        freePixmaps( dockPixmaps );
+
     }
 
     //_______________________________________________________
@@ -328,6 +341,19 @@ namespace Oxygen
 
     }
 
+    //______________________________________________
+    void ShadowHelper::freePixmaps( const QVector<Qt::HANDLE>& pixmaps ) const
+    {
+
+        #ifdef Q_WS_X11
+        foreach( const Qt::HANDLE& value, pixmaps )
+        { if( value ) XFreePixmap( QX11Info::display(), value ); }
+        #else
+        Q_UNUSED( pixmaps );
+        #endif
+
+    }
+
     //_______________________________________________________
     bool ShadowHelper::installX11Shadows( QWidget* widget )
     {
@@ -32,6 +32,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QMap>
+#include <QtGui/QImage>
 
 #ifdef Q_WS_X11
 #include <X11/Xdefs.h>
@@ -114,6 +115,9 @@ namespace Oxygen
         // create pixmap handle from pixmap
         Qt::HANDLE createPixmap( const QPixmap& ) const;
 
+        //! free pixmap handles
+        void freePixmaps( const QVector<Qt::HANDLE>& ) const;
+
         //! install shadow X11 property on given widget
         /*!
         shadow atom and property specification available at
@@ -144,6 +148,12 @@ namespace Oxygen
         TileSet _dockTiles;
         //@}
 
+        //!@name shadow images, used to detect configuration changes
+        //@{
+        QImage _shadowImage;
+        QImage _dockShadowImage;
+        //@}
+
         //! number of pixmaps
         enum { numPixmaps = 8 };
 
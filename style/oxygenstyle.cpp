@@ -191,6 +191,7 @@ namespace Oxygen
         // use DBus connection to update on oxygen configuration change
         QDBusConnection dbus = QDBusConnection::sessionBus();
         dbus.connect( QString(), "/OxygenStyle", "org.kde.Oxygen.Style", "reparseConfiguration", this, SLOT(oxygenConfigurationChanged()) );
+        dbus.connect( QString(), "/OxygenStyle", "org.kde.Oxygen.Style", "printCacheStatistics", this, SLOT(printCacheStatistics()) );
 
         // call the slot directly; this initial call will set up things that also
         // need to be reset when the system palette changes
@@ -8035,6 +8036,13 @@ namespace Oxygen
 
     }
 
+    //_____________________________________________________________________
+    void Style::printCacheStatistics( void ) const
+    {
+        QTextStream stream( stderr );
+        CacheBudget::instance().print( stream );
+    }
+
     //_____________________________________________________________________
     void Style::oxygenConfigurationChanged( void )
     {
@@ -8057,6 +8065,7 @@ namespace Oxygen
             StyleConfigData::maxCacheSize():0 );
 
         helper().setMaxCacheSize( cacheSize );
+        helper().setMaxCacheMemory( StyleConfigData::maxCacheMemory() );
 
         // reinitialize engines
         animations().setupEngines();
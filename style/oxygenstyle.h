@@ -202,6 +202,9 @@ namespace Oxygen
         //! needed to update style when configuration is changed
         void globalPaletteChanged( void );
 
+        //! print cache statistics to stderr
+        void printCacheStatistics( void ) const;
+
         //! copied from kstyle
         int layoutSpacingImplementation(
             QSizePolicy::ControlType, QSizePolicy::ControlType, Qt::Orientation,
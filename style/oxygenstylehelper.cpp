@@ -55,6 +55,24 @@ namespace Oxygen
 
         #endif
 
+        // cache names, used for statistics
+        _dialSlabCache.setName( "dialSlab" );
+        _roundSlabCache.setName( "roundSlab" );
+        _sliderSlabCache.setName( "sliderSlab" );
+        _holeCache.setName( "hole" );
+        _scrollHandleCache.setName( "scrollHandle" );
+        _midColorCache.setName( "midColor" );
+        _dockWidgetButtonCache.setName( "dockWidgetButton" );
+        _cornerCache.setName( "corner" );
+        _holeFlatCache.setName( "holeFlat" );
+        _slopeCache.setName( "slope" );
+        _grooveCache.setName( "groove" );
+        _slitCache.setName( "slit" );
+        _dockFrameCache.setName( "dockFrame" );
+        _scrollHoleCache.setName( "scrollHole" );
+        _selectionCache.setName( "selection" );
+        _progressBarCache.setName( "progressBar" );
+
     }
 
     //______________________________________________________________________________
@@ -429,10 +447,8 @@ namespace Oxygen
     //______________________________________________________________________________
     QPixmap StyleHelper::dialSlab( const QColor& color, const QColor& glow, qreal shade, int size )
     {
-        Oxygen::Cache<QPixmap>::Value* cache =  _dialSlabCache.get( color );
-
         const quint64 key( ( colorKey(glow) << 32 ) | ( quint64( 256.0 * shade ) << 24 ) | size );
-        QPixmap *pixmap = cache->object( key );
+        QPixmap *pixmap = _dialSlabCache.object( color, key );
         if ( !pixmap )
         {
             pixmap = new QPixmap( size, size );
@@ -482,7 +498,7 @@ namespace Oxygen
             }
 
 
-            cache->insert( key, pixmap );
+            _dialSlabCache.insert( color, key, pixmap );
 
         }
 
@@ -494,10 +510,8 @@ namespace Oxygen
     QPixmap StyleHelper::roundSlab( const QColor& color, const QColor& glow, qreal shade, int size )
     {
 
-        Oxygen::Cache<QPixmap>::Value* cache( _roundSlabCache.get( color ) );
-
         const quint64 key( ( colorKey(glow) << 32 ) | ( quint64( 256.0 * shade ) << 24 ) | size );
-        QPixmap *pixmap = cache->object( key );
+        QPixmap *pixmap = _roundSlabCache.object( color, key );
 
         if ( !pixmap )
         {
@@ -519,7 +533,7 @@ namespace Oxygen
             drawRoundSlab( p, color, shade );
 
             p.end();
-            cache->insert( key, pixmap );
+            _roundSlabCache.insert( color, key, pixmap );
 
         }
         return *pixmap;
@@ -529,10 +543,8 @@ namespace Oxygen
     QPixmap StyleHelper::sliderSlab( const QColor& color, const QColor& glow, bool sunken, qreal shade, int size )
     {
 
-        Oxygen::Cache<QPixmap>::Value* cache( _sliderSlabCache.get( color ) );
-
         const quint64 key( ( colorKey(glow) << 32 ) | ( quint64( 256.0 * shade ) << 24 ) | (sunken << 23 ) | size );
-        QPixmap *pixmap = cache->object( key );
+        QPixmap *pixmap = _sliderSlabCache.object( color, key );
 
         if ( !pixmap )
         {
@@ -553,7 +565,7 @@ namespace Oxygen
             drawSliderSlab( p, color, sunken, shade );
 
             p.end();
-            cache->insert( key, pixmap );
+            _sliderSlabCache.insert( color, key, pixmap );
 
         }
         return *pixmap;
@@ -838,99 +850,105 @@ namespace Oxygen
     {
 
         // get key
-        Oxygen::Cache<TileSet>::Value* cache( _holeCache.get( glow ) );
-
         const quint64 key( ( colorKey(color) << 32 ) | (size << 4) | options );
-        TileSet *tileSet = cache->object( key );
+        TileSet *tileSet = _holeCache.object( glow, key );
 
         if ( !tileSet )
         {
+            QPixmap pixmap;
+            const QString sharedKey( QString( "hole-%1-%2-%3-%4" ).arg( colorKey(color), 0, 16 ).arg( colorKey(glow), 0, 16 ).arg( size ).arg( int( options ) ) );
+            if( !findSharedPixmap( sharedKey, pixmap ) )
+            {
 
-            // first create shadow
-            int shadowSize( (size*5)/7 );
-            QPixmap shadowPixmap( shadowSize*2, shadowSize*2 );
+                // first create shadow
+                int shadowSize( (size*5)/7 );
+                QPixmap shadowPixmap( shadowSize*2, shadowSize*2 );
 
-            // calc alpha channel and fade
-            const int alpha( glow.isValid() ? glow.alpha():0 );
+                // calc alpha channel and fade
+                const int alpha( glow.isValid() ? glow.alpha():0 );
 
-            {
-                shadowPixmap.fill( Qt::transparent );
+                {
+                    shadowPixmap.fill( Qt::transparent );
 
-                QPainter p( &shadowPixmap );
-                p.setRenderHints( QPainter::Antialiasing );
-                p.setPen( Qt::NoPen );
-                p.setWindow( 0, 0, 10, 10 );
+                    QPainter p( &shadowPixmap );
+                    p.setRenderHints( QPainter::Antialiasing );
+                    p.setPen( Qt::NoPen );
+                    p.setWindow( 0, 0, 10, 10 );
 
-                // fade-in shadow
-                if( alpha < 255 )
-                {
-                    QColor shadowColor( calcShadowColor( color ) );
-                    shadowColor.setAlpha( 255-alpha );
-                    drawInverseShadow( p, shadowColor, 1, 8, 0.0 );
-                }
+                    // fade-in shadow
+                    if( alpha < 255 )
+                    {
+                        QColor shadowColor( calcShadowColor( color ) );
+                        shadowColor.setAlpha( 255-alpha );
+                        drawInverseShadow( p, shadowColor, 1, 8, 0.0 );
+                    }
 
-                // fade-out glow
-                if( alpha > 0 )
-                { drawInverseGlow( p, glow, 1, 8, shadowSize ); }
+                    // fade-out glow
+                    if( alpha > 0 )
+                    { drawInverseGlow( p, glow, 1, 8, shadowSize ); }
 
-                p.end();
+                    p.end();
 
-            }
+                }
 
-            // create pixmap
-            QPixmap pixmap( size*2, size*2 );
-            pixmap.fill( Qt::transparent );
+                // create pixmap
+                pixmap = QPixmap( size*2, size*2 );
+                pixmap.fill( Qt::transparent );
 
-            QPainter p( &pixmap );
-            p.setRenderHints( QPainter::Antialiasing );
-            p.setPen( Qt::NoPen );
-            p.setWindow( 0, 0, 14, 14 );
+                QPainter p( &pixmap );
+                p.setRenderHints( QPainter::Antialiasing );
+                p.setPen( Qt::NoPen );
+                p.setWindow( 0, 0, 14, 14 );
 
-            // hole mask
-            p.setCompositionMode( QPainter::CompositionMode_DestinationOut );
-            p.setBrush( Qt::black );
+                // hole mask
+                p.setCompositionMode( QPainter::CompositionMode_DestinationOut );
+                p.setBrush( Qt::black );
 
-            p.drawRoundedRect( QRectF( 1, 1, 12, 12 ), 2.5, 2.5 );
-            p.setCompositionMode( QPainter::CompositionMode_SourceOver );
+                p.drawRoundedRect( QRectF( 1, 1, 12, 12 ), 2.5, 2.5 );
+                p.setCompositionMode( QPainter::CompositionMode_SourceOver );
 
-            // render shadow
-            TileSet(
-                shadowPixmap, shadowSize, shadowSize, shadowSize,
-                shadowSize, shadowSize-1, shadowSize, 2, 1 ).
-                render( pixmap.rect(), &p );
+                // render shadow
+                TileSet(
+                    shadowPixmap, shadowSize, shadowSize, shadowSize,
+                    shadowSize, shadowSize-1, shadowSize, 2, 1 ).
+                    render( pixmap.rect(), &p );
 
-            if( (options&HoleOutline) && alpha < 255 )
-            {
-                QColor dark( calcDarkColor( color ) );
-                dark.setAlpha( 255 - alpha );
-                QLinearGradient blend( 0, 0, 0, 14 );
-                blend.setColorAt( 0, Qt::transparent );
-                blend.setColorAt( 0.8, dark );
+                if( (options&HoleOutline) && alpha < 255 )
+                {
+                    QColor dark( calcDarkColor( color ) );
+                    dark.setAlpha( 255 - alpha );
+                    QLinearGradient blend( 0, 0, 0, 14 );
+                    blend.setColorAt( 0, Qt::transparent );
+                    blend.setColorAt( 0.8, dark );
+
+                    p.setBrush( Qt::NoBrush );
+                    p.setPen( QPen( blend, 1 ) );
+                    p.drawRoundedRect( QRectF( 1.5, 1.5, 11, 11 ), 3.0, 3.0 );
+                    p.setPen( Qt::NoPen );
+                }
 
-                p.setBrush( Qt::NoBrush );
-                p.setPen( QPen( blend, 1 ) );
-                p.drawRoundedRect( QRectF( 1.5, 1.5, 11, 11 ), 3.0, 3.0 );
-                p.setPen( Qt::NoPen );
-            }
+                if( options&HoleContrast )
+                {
+                    QColor light( calcLightColor( color ) );
+                    QLinearGradient blend( 0, 0, 0, 18 );
+                    blend.setColorAt( 0.5, Qt::transparent );
+                    blend.setColorAt( 1.0, light );
+
+                    p.setBrush( Qt::NoBrush );
+                    p.setPen( QPen( blend, 1 ) );
+                    p.drawRoundedRect( QRectF( 0.5, 0.5, 13, 13 ), 4.0, 4.0 );
+                    p.setPen( Qt::NoPen );
+                }
 
-            if( options&HoleContrast )
-            {
-                QColor light( calcLightColor( color ) );
-                QLinearGradient blend( 0, 0, 0, 18 );
-                blend.setColorAt( 0.5, Qt::transparent );
-                blend.setColorAt( 1.0, light );
+                p.end();
 
-                p.setBrush( Qt::NoBrush );
-                p.setPen( QPen( blend, 1 ) );
-                p.drawRoundedRect( QRectF( 0.5, 0.5, 13, 13 ), 4.0, 4.0 );
-                p.setPen( Qt::NoPen );
-            }
+                insertSharedPixmap( sharedKey, pixmap );
 
-            p.end();
+            }
 
             // create tileset and return
             tileSet = new TileSet( pixmap, size, size, size, size, size-1, size, 2, 1 );
-            cache->insert( key, tileSet );
+            _holeCache.insert( glow, key, tileSet );
         }
 
         return tileSet;
@@ -1039,64 +1057,71 @@ namespace Oxygen
     {
 
         // get key
-        Oxygen::Cache<TileSet>::Value* cache( _scrollHandleCache.get( glow ) );
-
         const quint64 key( ( colorKey(color) << 32 ) | size );
-        TileSet *tileSet = cache->object( key );
+        TileSet *tileSet = _scrollHandleCache.object( glow, key );
 
         if ( !tileSet )
         {
-            QPixmap pm( 2*size, 2*size );
-            pm.fill( Qt::transparent );
-
-            QPainter p( &pm );
-            p.setRenderHints( QPainter::Antialiasing );
-            p.setPen( Qt::NoPen );
-            p.setWindow( 0, 0, 14, 14 );
-
-            QPixmap shadowPixmap( 10, 10 );
+            QPixmap pm;
+            const QString sharedKey( QString( "scrollHandle-%1-%2-%3" ).arg( colorKey(color), 0, 16 ).arg( colorKey(glow), 0, 16 ).arg( size ) );
+            if( !findSharedPixmap( sharedKey, pm ) )
             {
 
-                shadowPixmap.fill( Qt::transparent );
+                pm = QPixmap( 2*size, 2*size );
+                pm.fill( Qt::transparent );
 
-                QPainter p( &shadowPixmap );
+                QPainter p( &pm );
                 p.setRenderHints( QPainter::Antialiasing );
                 p.setPen( Qt::NoPen );
+                p.setWindow( 0, 0, 14, 14 );
 
-                // shadow/glow
-                drawOuterGlow( p, glow, 10 );
+                QPixmap shadowPixmap( 10, 10 );
+                {
 
-                p.end();
-            }
+                    shadowPixmap.fill( Qt::transparent );
 
-            TileSet( shadowPixmap, 4, 4, 1, 1 ).render( QRect( 0, 0, 14, 14 ), &p, TileSet::Full );
+                    QPainter p( &shadowPixmap );
+                    p.setRenderHints( QPainter::Antialiasing );
+                    p.setPen( Qt::NoPen );
 
-            // outline
-            {
-                const QColor mid( calcMidColor( color ) );
-                QLinearGradient lg( 0, 3, 0, 11 );
-                lg.setColorAt( 0, color );
-                lg.setColorAt( 1, mid );
-                p.setPen( Qt::NoPen );
-                p.setBrush( lg );
-                p.drawRoundedRect( QRectF( 3, 3, 8, 8 ), 2.5, 2.5 );
-            }
+                    // shadow/glow
+                    drawOuterGlow( p, glow, 10 );
 
-            // contrast
-            {
-                const QColor light( calcLightColor( color ) );
-                QLinearGradient lg( 0, 3, 0, 11 );
-                lg.setColorAt( 0., alphaColor( light, 0.9 ) );
-                lg.setColorAt( 0.5, alphaColor( light, 0.44 ) );
-                p.setBrush( lg );
-                p.drawRoundedRect( QRectF( 3, 3, 8, 8 ), 2.5, 2.5 );
-            }
+                    p.end();
+                }
 
-            p.end();
+                TileSet( shadowPixmap, 4, 4, 1, 1 ).render( QRect( 0, 0, 14, 14 ), &p, TileSet::Full );
+
+                // outline
+                {
+                    const QColor mid( calcMidColor( color ) );
+                    QLinearGradient lg( 0, 3, 0, 11 );
+                    lg.setColorAt( 0, color );
+                    lg.setColorAt( 1, mid );
+                    p.setPen( Qt::NoPen );
+                    p.setBrush( lg );
+                    p.drawRoundedRect( QRectF( 3, 3, 8, 8 ), 2.5, 2.5 );
+                }
+
+                // contrast
+                {
+                    const QColor light( calcLightColor( color ) );
+                    QLinearGradient lg( 0, 3, 0, 11 );
+                    lg.setColorAt( 0., alphaColor( light, 0.9 ) );
+                    lg.setColorAt( 0.5, alphaColor( light, 0.44 ) );
+                    p.setBrush( lg );
+                    p.drawRoundedRect( QRectF( 3, 3, 8, 8 ), 2.5, 2.5 );
+                }
+
+                p.end();
+
+                insertSharedPixmap( sharedKey, pm );
+
+            }
 
             // create tileset and return
             tileSet = new TileSet( pm, size-1, size, 1, 1 );
-            cache->insert( key, tileSet );
+            _scrollHandleCache.insert( glow, key, tileSet );
 
         }
 
@@ -34,9 +34,82 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTextStream>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace Oxygen
 {
 
+    //________________________________________________
+    //! interpolate premultiplied pixels, two channels at a time: ( start*(255-alpha) + end*alpha )/255
+    static inline quint32 interpolate( quint32 start, quint32 end, quint32 alpha )
+    {
+        const quint32 inverse( 255 - alpha );
+
+        quint32 low( ( start&0xff00ff )*inverse + ( end&0xff00ff )*alpha + 0x800080 );
+        low = ( ( low + ( ( low >> 8 )&0xff00ff ) ) >> 8 )&0xff00ff;
+
+        quint32 high( ( ( start >> 8 )&0xff00ff )*inverse + ( ( end >> 8 )&0xff00ff )*alpha + 0x800080 );
+        high = ( high + ( ( high >> 8 )&0xff00ff ) )&0xff00ff00;
+
+        return high | low;
+    }
+
+    //________________________________________________
+    //! interpolate premultiplied images in given rect. All images must have the same size
+    static void interpolate( const QImage& start, const QImage& end, QImage& target, int alpha, const QRect& rect )
+    {
+
+        for( int y = rect.top(); y <= rect.bottom(); ++y )
+        {
+
+            const quint32* startLine( reinterpret_cast<const quint32*>( start.constScanLine( y ) ) );
+            const quint32* endLine( reinterpret_cast<const quint32*>( end.constScanLine( y ) ) );
+            quint32* targetLine( reinterpret_cast<quint32*>( target.scanLine( y ) ) );
+
+            int x( rect.left() );
+            const int xMax( rect.right() + 1 );
+
+            #ifdef __SSE2__
+            {
+                const __m128i zero( _mm_setzero_si128() );
+                const __m128i alpha8( _mm_set1_epi16( alpha ) );
+                const __m128i inverse8( _mm_set1_epi16( 255 - alpha ) );
+                const __m128i round( _mm_set1_epi16( 128 ) );
+
+                for( ; x + 4 <= xMax; x += 4 )
+                {
+
+                    const __m128i startPixels( _mm_loadu_si128( reinterpret_cast<const __m128i*>( startLine + x ) ) );
+                    const __m128i endPixels( _mm_loadu_si128( reinterpret_cast<const __m128i*>( endLine + x ) ) );
+
+                    // weighted sum on 16 bits channels, divided by 255
+                    __m128i low( _mm_add_epi16(
+                        _mm_mullo_epi16( _mm_unpacklo_epi8( startPixels, zero ), inverse8 ),
+                        _mm_mullo_epi16( _mm_unpacklo_epi8( endPixels, zero ), alpha8 ) ) );
+                    __m128i high( _mm_add_epi16(
+                        _mm_mullo_epi16( _mm_unpackhi_epi8( startPixels, zero ), inverse8 ),
+                        _mm_mullo_epi16( _mm_unpackhi_epi8( endPixels, zero ), alpha8 ) ) );
+                    low = _mm_add_epi16( low, round );
+                    high = _mm_add_epi16( high, round );
+                    low = _mm_srli_epi16( _mm_add_epi16( low, _mm_srli_epi16( low, 8 ) ), 8 );
+                    high = _mm_srli_epi16( _mm_add_epi16( high, _mm_srli_epi16( high, 8 ) ), 8 );
+
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( targetLine + x ), _mm_packus_epi16( low, high ) );
+
+                }
+            }
+            #endif
+
+            // remaining pixels
+            for( ; x < xMax; ++x )
+            { targetLine[x] = interpolate( startLine[x], endLine[x], alpha ); }
+
+        }
+
+    }
+
     //________________________________________________
     bool TransitionWidget::_paintEnabled = true;
     bool TransitionWidget::paintEnabled( void )
@@ -49,6 +122,8 @@ namespace Oxygen
         QWidget( parent ),
         _flags( None ),
         _animation( new Animation( duration, this ) ),
+        _currentPixmapDirty( false ),
+        _currentAlpha( 0 ),
         _opacity( 0 )
     {
 
@@ -112,6 +187,17 @@ namespace Oxygen
         QRect rect = event->rect();
         if( !rect.isValid() ) rect = this->rect();
 
+        // cross-fade start and end pixmaps in one pass, when possible
+        if( opacity() >= 0.004 && opacity() <= 0.996 && crossFade( rect ) )
+        {
+            _currentPixmapDirty = true;
+            QPainter p( this );
+            p.setClipRect( event->rect() );
+            p.drawImage( rect.topLeft(), _currentImage, rect );
+            p.end();
+            return;
+        }
+
         // local pixmap
         const bool paintOnWidget( testFlag( PaintOnWidget ) && !testFlag( Transparent ) );
         if( !paintOnWidget )
@@ -124,6 +210,7 @@ namespace Oxygen
 
         // fill
         _currentPixmap.fill( Qt::transparent );
+        _currentPixmapDirty = false;
 
         // copy local pixmap to current
         {
@@ -289,4 +376,47 @@ namespace Oxygen
         return;
     }
 
+    //________________________________________________
+    const QPixmap& TransitionWidget::currentPixmap( void )
+    {
+
+        // only the painted rect of the current image is up to date.
+        // Interpolate the full image using the last painted alpha, since opacity might have been reset since then
+        if( _currentPixmapDirty )
+        {
+            _currentPixmapDirty = false;
+            if( _startImage.size() == _currentImage.size() && _endImage.size() == _currentImage.size() )
+            {
+                interpolate( _startImage, _endImage, _currentImage, _currentAlpha, _currentImage.rect() );
+                _currentPixmap = QPixmap::fromImage( _currentImage );
+            }
+        }
+
+        return _currentPixmap;
+
+    }
+
+    //________________________________________________
+    bool TransitionWidget::crossFade( const QRect& rect )
+    {
+
+        // both pixmaps must match the widget size
+        if( _startPixmap.isNull() || _endPixmap.isNull() ) return false;
+        if( _startPixmap.size() != size() || _endPixmap.size() != size() ) return false;
+
+        // convert pixmaps once per transition
+        if( _startImage.isNull() ) _startImage = _startPixmap.toImage().convertToFormat( QImage::Format_ARGB32_Premultiplied );
+        if( _endImage.isNull() ) _endImage = _endPixmap.toImage().convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+        // reuse current image across frames
+        if( _currentImage.size() != size() )
+        { _currentImage = QImage( size(), QImage::Format_ARGB32_Premultiplied ); }
+
+        _currentAlpha = qRound( opacity()*255 );
+        const QRect local( rect & _currentImage.rect() );
+        if( local.isValid() ) interpolate( _startImage, _endImage, _currentImage, _currentAlpha, local );
+        return true;
+
+    }
+
 }
@@ -29,6 +29,7 @@
 #include "oxygenanimation.h"
 
 #include <QtCore/QWeakPointer>
+#include <QtGui/QImage>
 #include <QtGui/QWidget>
 
 #include <cmath>
@@ -123,7 +124,12 @@ namespace Oxygen
 
         //! start
         void setStartPixmap( QPixmap pixmap )
-        { _startPixmap = pixmap; }
+        {
+            // update current pixmap while start image is still valid
+            if( _currentPixmapDirty ) currentPixmap();
+            _startPixmap = pixmap;
+            _startImage = QImage();
+        }
 
         //! start
         const QPixmap& startPixmap( void ) const
@@ -137,7 +143,9 @@ namespace Oxygen
         void setEndPixmap( QPixmap pixmap )
         {
             _endPixmap = pixmap;
+            _endImage = QImage();
             _currentPixmap = pixmap;
+            _currentPixmapDirty = false;
         }
 
         //! start
@@ -145,8 +153,8 @@ namespace Oxygen
         { return _endPixmap; }
 
         //! current
-        const QPixmap& currentPixmap( void ) const
-        { return _currentPixmap; }
+        /*! it is updated from the last cross-faded image if needed */
+        const QPixmap& currentPixmap( void );
 
         //@}
 
@@ -195,6 +203,10 @@ namespace Oxygen
         //! fade pixmap
         virtual void fade( const QPixmap& source, QPixmap& target, qreal opacity, const QRect& ) const;
 
+        //! cross-fade start and end pixmaps into current image, in given rect
+        /*! returns false if pixmaps are not suitable, in which case the generic painting is used */
+        bool crossFade( const QRect& );
+
         //! apply step
         virtual qreal digitize( const qreal& value ) const
         {
@@ -225,6 +237,20 @@ namespace Oxygen
         //! current pixmap
         QPixmap _currentPixmap;
 
+        //!@name images used for cross-fading
+        /*! start and end images are converted once per transition, current image is reused across frames */
+        //@{
+        QImage _startImage;
+        QImage _endImage;
+        QImage _currentImage;
+        //@}
+
+        //! true when current image is more recent than current pixmap
+        bool _currentPixmapDirty;
+
+        //! alpha used for the last cross-faded image
+        int _currentAlpha;
+
         //! current state opacity
         qreal _opacity;
 